@@ -1,11 +1,26 @@
 #version 460 core
 
 in vec2 vUV;
+in float vAO;
+in float vLight;
+flat in float vTile;
 
 out vec4 oColor;
 
 uniform sampler2D uTexture;
 
+// Atlas of 16x16 tiles, the first one in the top left corner of the image, which is loaded flipped
+// Coordinates wrap inside the tile, gradients are taken before the wrap so it doesn't pick the smallest mipmap along the seams
+vec4 SampleTile(float tile, vec2 uv) {
+	vec2 origin = vec2(mod(tile, 16.0), 15.0 - floor(tile / 16.0));
+	return textureGrad(uTexture, (origin + fract(uv)) / 16.0, dFdx(uv) / 16.0, dFdy(uv) / 16.0);
+}
+
 void main() {
-	oColor = texture(uTexture, vUV);
+	// Fully occluded corners keep some light, so they don't turn black
+	float ao = mix(0.45, 1.0, vAO);
+	// Every light level is 80% as bright as the one above, with a floor so unlit caves stay visible
+	float light = max(pow(0.8, 15.0 * (1.0 - vLight)), 0.05);
+	vec4 color = SampleTile(vTile, vUV);
+	oColor = vec4(color.rgb * ao * light, color.a);
 }
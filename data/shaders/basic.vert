@@ -2,12 +2,23 @@
 
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aUV;
+layout (location = 2) in float aAO;
+layout (location = 3) in float aLight;
+layout (location = 4) in float aTile;
 
+out vec3 vPos;
 out vec2 vUV;
+out float vAO;
+out float vLight;
+flat out float vTile;
 
 uniform mat4 uPVMMat;
 
 void main() {
 	gl_Position = uPVMMat * vec4(aPos, 1.0);
+	vPos = aPos;
 	vUV = aUV;
+	vAO = aAO;
+	vLight = aLight;
+	vTile = aTile;
 }
@@ -0,0 +1,27 @@
+#version 460 core
+
+in vec2 vUV;
+in float vAO;
+in float vLight;
+flat in float vTile;
+
+out vec4 oColor;
+
+uniform sampler2D uTexture;
+
+// Same as basic.frag
+vec4 SampleTile(float tile, vec2 uv) {
+	vec2 origin = vec2(mod(tile, 16.0), 15.0 - floor(tile / 16.0));
+	return textureGrad(uTexture, (origin + fract(uv)) / 16.0, dFdx(uv) / 16.0, dFdy(uv) / 16.0);
+}
+
+void main() {
+	// Same shading as basic.frag
+	float ao = mix(0.45, 1.0, vAO);
+	float light = max(pow(0.8, 15.0 * (1.0 - vLight)), 0.05);
+	vec4 color = SampleTile(vTile, vUV);
+	if (color.a < 0.5) {
+		discard; // Kept out of basic.frag, a shader that may discard loses early depth testing
+	}
+	oColor = vec4(color.rgb * ao * light, 1.0);
+}
@@ -0,0 +1,6 @@
+#version 460 core
+
+// Depth only, for the occlusion culling prepass
+
+void main() {
+}
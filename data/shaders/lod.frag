@@ -0,0 +1,49 @@
+#version 460 core
+
+in vec3 vPos;
+in vec2 vUV;
+in float vAO;
+in float vLight;
+flat in float vTile;
+
+out vec4 oColor;
+
+uniform sampler2D uTexture;
+// Region drawn by the finer level of detail, same test as LoadRegion::Contains
+uniform int uClipShape; // LoadRegion::Shape
+uniform float uClipRadius;
+uniform float uClipHeight;
+uniform vec3 uClipCenter; // In cells
+uniform float uClipCellSize; // In blocks
+
+// Same as basic.frag
+vec4 SampleTile(float tile, vec2 uv) {
+	vec2 origin = vec2(mod(tile, 16.0), 15.0 - floor(tile / 16.0));
+	return textureGrad(uTexture, (origin + fract(uv)) / 16.0, dFdx(uv) / 16.0, dFdy(uv) / 16.0);
+}
+
+bool InsideClipRegion(vec3 pos) {
+	vec3 offset = floor(pos / uClipCellSize) - uClipCenter;
+	float radius2 = uClipRadius * (uClipRadius + 1.0);
+	if (uClipShape == 0) {
+		return all(lessThanEqual(abs(offset), vec3(uClipRadius)));
+	}
+	if (uClipShape == 1) {
+		return dot(offset.xz, offset.xz) <= radius2 && abs(offset.y) <= uClipHeight;
+	}
+	return dot(offset, offset) <= radius2;
+}
+
+void main() {
+	// Faces on the clip border belong to the block behind them, so test a point slightly inside that block
+	vec3 normal = normalize(cross(dFdx(vPos), dFdy(vPos)));
+	if (InsideClipRegion(vPos - 0.01 * normal)) {
+		discard;
+	}
+
+	// Same shading as basic.frag
+	float ao = mix(0.45, 1.0, vAO);
+	float light = max(pow(0.8, 15.0 * (1.0 - vLight)), 0.05);
+	vec4 color = SampleTile(vTile, vUV);
+	oColor = vec4(color.rgb * ao * light, color.a);
+}
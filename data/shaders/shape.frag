@@ -0,0 +1,9 @@
+#version 460 core
+
+in vec4 vColor;
+
+out vec4 oColor;
+
+void main() {
+	oColor = vColor;
+}
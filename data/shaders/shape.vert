@@ -0,0 +1,13 @@
+#version 460 core
+
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aColor;
+
+out vec4 vColor;
+
+uniform mat4 uProjMat;
+
+void main() {
+	gl_Position = uProjMat * vec4(aPos, 0.0, 1.0);
+	vColor = aColor;
+}
@@ -0,0 +1,51 @@
+#include "collision_benchmark.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <chrono>
+#include <src/physics/physics.h>
+
+namespace bench {
+
+void RunCollisionBenchmark(const ChunkManager& chunk_manager, glm::vec3 center, int num_bodies, int num_ticks, float tick_rate, unsigned int seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> offset_dist(-24.0f, 24.0f);
+	std::uniform_real_distribution<float> height_dist(0.0f, 8.0f);
+	std::uniform_real_distribution<float> velocity_dist(-5.0f, 5.0f);
+
+	std::vector<PhysicsBody> bodies(num_bodies);
+	for (auto& body : bodies) {
+		body.position = center + glm::vec3(offset_dist(rng), height_dist(rng), offset_dist(rng));
+		body.velocity = glm::vec3(velocity_dist(rng), 0.0f, velocity_dist(rng));
+	}
+
+	Physics physics(&chunk_manager);
+	const float tick_dt = 1.0f / tick_rate;
+	int num_grounded = 0;
+	const auto time_start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < num_ticks; ++tick) {
+		for (auto& body : bodies) {
+			// Keep the bodies walking, so they keep bumping into things
+			if (body.velocity.x == 0.0f && body.velocity.z == 0.0f) {
+				body.velocity.x = velocity_dist(rng);
+				body.velocity.z = velocity_dist(rng);
+			}
+			physics.Step(body, tick_dt);
+		}
+	}
+	float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count();
+	for (const auto& body : bodies) {
+		num_grounded += body.on_ground ? 1 : 0;
+	}
+
+	int num_steps = num_bodies * num_ticks;
+	std::cout << "[Collision benchmark] " <<
+		"bodies=" << num_bodies << ", " <<
+		"ticks=" << num_ticks << ", " <<
+		"grounded=" << num_grounded << ", " <<
+		"steps/s=" << (seconds > 0.0f ? num_steps / seconds : 0.0f) << ", " <<
+		"bodies_at_" << (int)tick_rate << "Hz=" << (seconds > 0.0f ? num_steps / seconds / tick_rate : 0.0f) << std::endl;
+}
+
+} // namespace bench
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+class ChunkManager;
+
+namespace bench {
+
+// Simulate many bodies falling and walking around center and report collision steps per second
+void RunCollisionBenchmark(const ChunkManager& chunk_manager, glm::vec3 center, int num_bodies, int num_ticks, float tick_rate, unsigned int seed = 0);
+
+} // namespace bench
@@ -0,0 +1,45 @@
+#include "edit_benchmark.h"
+
+#include <iostream>
+#include <src/world/chunk_manager.h>
+
+EditBenchmark::EditBenchmark(ChunkManager* chunk_manager, int edits_per_second, int radius, unsigned int seed) : rng_(seed) {
+	chunk_manager_ = chunk_manager;
+	edits_per_second_ = edits_per_second;
+	radius_ = radius;
+	chunk_manager_->ResetEditStats();
+}
+
+void EditBenchmark::Update(float dt, glm::vec3 center) {
+	std::uniform_int_distribution<int> offset_dist(-radius_, radius_);
+	std::uniform_int_distribution<int> block_dist(0, 1);
+
+	edit_debt_ += edits_per_second_ * dt;
+	int num_edits = (int)edit_debt_;
+	edit_debt_ -= (float)num_edits;
+
+	glm::ivec3 origin(glm::floor(center));
+	for (int i = 0; i < num_edits; ++i) {
+		glm::ivec3 offset(offset_dist(rng_), offset_dist(rng_), offset_dist(rng_));
+		chunk_manager_->SetBlock(origin + offset, (uint8_t)block_dist(rng_));
+	}
+
+	++ticks_;
+	report_time_ += dt;
+	if (report_time_ >= 1.0f) {
+		Report();
+		chunk_manager_->ResetEditStats();
+		report_time_ = 0.0f;
+		ticks_ = 0;
+	}
+}
+
+void EditBenchmark::Report() {
+	const ChunkManager::EditStats& stats = chunk_manager_->GetEditStats();
+	float avg_latency_ms = stats.remeshes > 0 ? stats.total_latency_ms / stats.remeshes : 0.0f;
+	std::cout << "[Edit benchmark] " <<
+		"edits/s=" << stats.edits / report_time_ << ", " <<
+		"remeshes/tick=" << (float)stats.remeshes / ticks_ << ", " <<
+		"latency_avg=" << avg_latency_ms << "ms, " <<
+		"latency_max=" << stats.max_latency_ms << "ms" << std::endl;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <random>
+#include <glm/glm.hpp>
+
+class ChunkManager;
+
+// Stress test that applies random block edits around a point and reports remesh latency
+class EditBenchmark {
+public:
+	EditBenchmark(ChunkManager* chunk_manager, int edits_per_second, int radius, unsigned int seed = 0);
+
+	// Should be called once per simulation tick
+	void Update(float dt, glm::vec3 center);
+
+private:
+	void Report();
+
+private:
+	ChunkManager* chunk_manager_;
+	int edits_per_second_;
+	int radius_;
+	std::mt19937 rng_;
+
+	float edit_debt_ = 0.0f; // Fractional edits carried over to the next frame
+	float report_time_ = 0.0f;
+	int ticks_ = 0;
+};
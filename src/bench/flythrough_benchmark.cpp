@@ -0,0 +1,141 @@
+#include "flythrough_benchmark.h"
+
+#include <cmath>
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <src/utils/frame_stats.h>
+#include <src/utils/math.h>
+
+namespace {
+
+// Uniform Catmull-Rom spline, passes through p1 at t = 0 and p2 at t = 1
+glm::vec3 CatmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t) {
+	float t2 = t * t;
+	float t3 = t2 * t;
+	return 0.5f * (
+		2.0f * p1 +
+		(p2 - p0) * t +
+		(2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+		(3.0f * p1 - p0 - 3.0f * p2 + p3) * t3
+	);
+}
+
+} // namespace
+
+FlythroughBenchmark::FlythroughBenchmark(int num_frames, unsigned int seed) {
+	num_frames_ = std::max(num_frames, 2);
+	seed_ = seed;
+	samples_.resize(num_frames_);
+
+	// Random walk with limited turns, so the camera keeps flying into unloaded terrain
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> turn_dist(-0.6f, 0.6f);
+	std::uniform_real_distribution<float> height_dist(4.0f, 40.0f);
+	const int num_points = 18;
+	const float spacing = 48.0f;
+	float heading = 0.0f;
+	glm::vec3 point(0.0f, 20.0f, 0.0f);
+	for (int i = 0; i < num_points; ++i) {
+		control_points_.push_back(point);
+		heading += turn_dist(rng);
+		point += spacing * glm::vec3(-std::sin(heading), 0.0f, -std::cos(heading));
+		point.y = height_dist(rng);
+	}
+}
+
+FlythroughBenchmark::Pose FlythroughBenchmark::GetPose(int frame) const {
+	// The first and last control points only shape the ends of the path
+	auto position_at = [&](float t) {
+		const int num_segments = (int)control_points_.size() - 3;
+		float s = std::clamp(t, 0.0f, 1.0f) * num_segments;
+		int segment = std::min((int)s, num_segments - 1);
+		const glm::vec3* p = &control_points_[segment];
+		return CatmullRom(p[0], p[1], p[2], p[3], s - (float)segment);
+	};
+
+	float t = (float)frame / (float)(num_frames_ - 1);
+	float dt = 1.0f / (float)(num_frames_ - 1);
+	Pose pose;
+	pose.position = position_at(t);
+	glm::vec3 dir = position_at(t + dt) - position_at(t - dt);
+	if (glm::length(dir) > 0.0f) {
+		dir = glm::normalize(dir);
+	} else {
+		dir = glm::vec3(0.0f, 0.0f, -1.0f);
+	}
+	float pitch = std::clamp(std::asin(dir.y) - 0.2f, -math::kPiHalf + 0.1f, math::kPiHalf - 0.1f); // Look slightly down at the terrain
+	float yaw = std::atan2(-dir.x, -dir.z);
+	pose.rotation = glm::vec3(pitch, yaw, 0.0f);
+	return pose;
+}
+
+int FlythroughBenchmark::GetNumFrames() const {
+	return num_frames_;
+}
+
+bool FlythroughBenchmark::Record(int frame, const Sample& sample) {
+	if (frame < 0 || frame >= num_frames_) {
+		return false;
+	}
+	samples_[frame] = sample;
+	if (frame != num_frames_ - 1) {
+		return false;
+	}
+	WriteReport("flythrough");
+	return true;
+}
+
+void FlythroughBenchmark::WriteReport(const std::string& path) const {
+	std::ofstream csv(path + ".csv");
+	std::ofstream json(path + ".json");
+	if (!csv || !json) {
+		std::cerr << "[ERROR] Failed to write flythrough report " << path << std::endl;
+		return;
+	}
+
+	csv << "frame,frame_ms,sim_ms,render_ms,gpu_ms,chunks,loads,meshes,draw_calls,fragments\n";
+	FrameStats frame_stats(num_frames_);
+	double sim_ms = 0.0, render_ms = 0.0, gpu_ms = 0.0, draw_calls = 0.0, fragments = 0.0;
+	int64_t loads = 0, meshes = 0;
+	for (int i = 0; i < num_frames_; ++i) {
+		const Sample& s = samples_[i];
+		csv << i << ',' << s.frame_ms << ',' << s.sim_ms << ',' << s.render_ms << ',' << s.gpu_ms << ',' <<
+			s.chunks << ',' << s.loads << ',' << s.meshes << ',' << s.draw_calls << ',' << s.fragments << '\n';
+		frame_stats.Add(s.frame_ms);
+		sim_ms += s.sim_ms;
+		render_ms += s.render_ms;
+		gpu_ms += s.gpu_ms;
+		draw_calls += s.draw_calls;
+		fragments += (double)s.fragments;
+		loads += s.loads;
+		meshes += s.meshes;
+	}
+
+	FrameStats::Summary summary = frame_stats.Compute();
+	json << "{\n" <<
+		"  \"frames\": " << num_frames_ << ",\n" <<
+		"  \"seed\": " << seed_ << ",\n" <<
+		"  \"frame_ms\": { \"mean\": " << summary.mean_ms << ", \"p50\": " << summary.p50_ms << ", \"p95\": " << summary.p95_ms <<
+		", \"p99\": " << summary.p99_ms << ", \"max\": " << summary.max_ms << " },\n" <<
+		"  \"hitches\": " << summary.hitches << ",\n" <<
+		"  \"hitch_threshold_ms\": " << frame_stats.GetHitchThreshold() << ",\n" <<
+		"  \"sim_ms_mean\": " << sim_ms / num_frames_ << ",\n" <<
+		"  \"render_ms_mean\": " << render_ms / num_frames_ << ",\n" <<
+		"  \"gpu_ms_mean\": " << gpu_ms / num_frames_ << ",\n" <<
+		"  \"draw_calls_mean\": " << draw_calls / num_frames_ << ",\n" <<
+		"  \"fragments_mean\": " << fragments / num_frames_ << ",\n" <<
+		"  \"chunk_loads\": " << loads << ",\n" <<
+		"  \"chunk_meshes\": " << meshes << "\n" <<
+		"}\n";
+
+	std::cout << "[Flythrough benchmark] " <<
+		"frames=" << num_frames_ << ", " <<
+		"mean=" << summary.mean_ms << "ms, " <<
+		"p99=" << summary.p99_ms << "ms, " <<
+		"hitches=" << summary.hitches << ", " <<
+		"loads=" << loads << ", " <<
+		"meshes=" << meshes << ", " <<
+		"report=" << path << ".csv/.json" << std::endl;
+}
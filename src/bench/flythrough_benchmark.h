@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Scripted camera flight along a seeded spline for a fixed number of frames, for comparing builds
+// The path is read by the simulation thread, samples are recorded by the render thread
+class FlythroughBenchmark {
+public:
+	struct Pose {
+		glm::vec3 position;
+		glm::vec3 rotation; // Pitch, yaw, roll like Entity
+	};
+
+	struct Sample {
+		float frame_ms = 0.0f;
+		float sim_ms = 0.0f;
+		float render_ms = 0.0f; // CPU time spent in the render thread
+		float gpu_ms = 0.0f; // Latest resolved GPU time, which lags a few frames behind
+		int chunks = 0; // Chunks with a mesh
+		int loads = 0; // Chunks loaded and meshed since the previous frame
+		int meshes = 0;
+		int draw_calls = 0;
+		uint64_t fragments = 0; // Fragment shader invocations of the 3D passes, resolved a few frames late like gpu_ms
+	};
+
+	// At least 2 frames, the first and last pose are the ends of the path
+	FlythroughBenchmark(int num_frames, unsigned int seed = 0);
+
+	// Same frame, same pose, regardless of frame rate
+	Pose GetPose(int frame) const;
+	int GetNumFrames() const;
+
+	// Writes the report once the last frame has been recorded and returns true
+	bool Record(int frame, const Sample& sample);
+
+private:
+	void WriteReport(const std::string& path) const;
+
+private:
+	int num_frames_;
+	unsigned int seed_;
+	std::vector<glm::vec3> control_points_;
+
+	std::vector<Sample> samples_;
+};
@@ -0,0 +1,65 @@
+// Chunk streaming and block lookups through ChunkManager
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <src/world/chunk_manager.h>
+#include <src/world/chunk.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+int main() {
+	// Same horizontal view distance for every shape, the cylinder is the default
+	const std::pair<const char*, LoadRegion> regions[] = {
+		{ "cube", { LoadRegion::kCube, 4, 4 } },
+		{ "sphere", { LoadRegion::kSphere, 4, 4 } },
+		{ "cylinder", LoadRegion() },
+	};
+	for (const auto& [shape, region] : regions) {
+		const std::string name = std::string("chunk_map/load_region/") + shape;
+		int num_chunks = 0;
+		bench::Measure(name.c_str(), 5, 1, [&]() {
+			ChunkManager chunk_manager;
+			chunk_manager.SetBudget(bench::UnlimitedBudget());
+			chunk_manager.SetLoadRegion(region);
+			chunk_manager.Update(glm::vec3(0.0f));
+			num_chunks = (int)chunk_manager.GetChunks().size();
+		});
+		std::cout << "[Benchmark] name=" << name << ", chunks=" << num_chunks << std::endl;
+	}
+
+	ChunkManager chunk_manager;
+	chunk_manager.SetBudget(bench::UnlimitedBudget());
+	chunk_manager.Update(glm::vec3(0.0f));
+
+	// Positions are generated up front, so only the lookups are timed
+	const int num_lookups = 1 << 20;
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<int> dist(-64, 63);
+	std::vector<glm::ivec3> positions(num_lookups);
+	for (auto& pos : positions) {
+		pos = glm::ivec3(dist(rng), dist(rng), dist(rng));
+	}
+
+	bench::Measure("chunk_map/get_block_random", 15, num_lookups, [&]() {
+		int solid = 0;
+		for (const auto& pos : positions) {
+			solid += chunk_manager.GetBlock(pos);
+		}
+		bench::DoNotOptimize(solid);
+	});
+
+	// Walks along x, where consecutive blocks mostly share a chunk
+	bench::Measure("chunk_map/get_block_linear", 15, 128 * 128 * 8, [&]() {
+		int solid = 0;
+		for (int z = -64; z < 64; ++z) {
+			for (int y = -4; y < 4; ++y) {
+				for (int x = -64; x < 64; ++x) {
+					solid += chunk_manager.GetBlock({ x, y, z });
+				}
+			}
+		}
+		bench::DoNotOptimize(solid);
+	});
+
+	return 0;
+}
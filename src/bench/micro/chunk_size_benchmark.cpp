@@ -0,0 +1,156 @@
+// Chunk dimensions: draw calls against remesh cost, for the same region of hilly terrain
+#include <cmath>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <src/world/chunk.h>
+#include <src/world/lighting.h>
+#include <src/world/mesher.h>
+#include <src/utils/hash.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+namespace {
+
+// 256 blocks on each axis, divisible by every benchmarked shape
+const glm::ivec3 kRegionMin(-128, 0, -128);
+const glm::ivec3 kRegionMax(128, 256, 128);
+
+// Rolling hills, so the surface crosses chunks vertically as well as horizontally
+constexpr int kMinHeight = 80;
+constexpr int kMaxHeight = 176;
+
+int GetHeight(int x, int z) {
+	return 128 + (int)std::lround(48.0f * std::sin((float)x * 0.05f) * std::cos((float)z * 0.07f));
+}
+
+template<typename Shape>
+class World {
+public:
+	using ChunkType = BasicChunk<Shape>;
+
+	World() : solid_(glm::ivec3(0)) {
+		solid_.data_.fill(1);
+
+		// The region and a ring of neighbours, so its border chunks are culled like in game
+		// Chunks below the terrain share one solid chunk, chunks above it are left out and read as open sky
+		const glm::ivec3 size = GetSize();
+		const glm::ivec3 min = kRegionMin / size - 1;
+		const glm::ivec3 max = kRegionMax / size + 1;
+		glm::ivec3 index;
+		for (index.z = min.z; index.z < max.z; ++index.z) {
+			for (index.y = min.y; index.y < max.y; ++index.y) {
+				for (index.x = min.x; index.x < max.x; ++index.x) {
+					const glm::ivec3 origin = index * size;
+					if (origin.y >= kMaxHeight) {
+						continue;
+					}
+					if (origin.y + size.y <= kMinHeight) {
+						chunks_.emplace(index, &solid_);
+						continue;
+					}
+					owned_.push_back(std::make_unique<ChunkType>(index));
+					Generate(owned_.back().get());
+					chunks_.emplace(index, owned_.back().get());
+				}
+			}
+		}
+	}
+
+	const ChunkType* GetChunk(glm::ivec3 index) const {
+		auto it = chunks_.find(index);
+		return it != chunks_.end() ? it->second : nullptr;
+	}
+
+	mesher::BasicNeighborhood<Shape> GetNeighborhood(glm::ivec3 index) const {
+		mesher::BasicNeighborhood<Shape> neighbors;
+		for (int i = 0; i < 27; ++i) {
+			neighbors[i] = GetChunk(index + glm::ivec3(i % 3 - 1, i / 3 % 3 - 1, i / 9 - 1));
+		}
+		return neighbors;
+	}
+
+	static glm::ivec3 GetSize() {
+		return { Shape::kSizeX, Shape::kSizeY, Shape::kSizeZ };
+	}
+
+private:
+	static void Generate(ChunkType* chunk) {
+		const glm::ivec3 origin = chunk->index_ * GetSize();
+		for (int z = 0; z < Shape::kSizeZ; ++z) {
+			for (int x = 0; x < Shape::kSizeX; ++x) {
+				const int height = GetHeight(origin.x + x, origin.z + z);
+				for (int y = 0; y < Shape::kSizeY; ++y) {
+					const bool solid = origin.y + y < height;
+					chunk->data_[Shape::GetIndex(x, y, z)] = solid ? 1 : 0;
+					chunk->light_[Shape::GetIndex(x, y, z)] = solid ? 0 : light::Pack(light::kMaxLevel, 0);
+				}
+			}
+		}
+	}
+
+private:
+	ChunkType solid_;
+	std::vector<std::unique_ptr<ChunkType>> owned_;
+	std::unordered_map<glm::ivec3, const ChunkType*, hash::Hash<glm::ivec3>> chunks_;
+};
+
+template<typename Shape>
+void MeasureShape() {
+	const std::string name = "chunk_size/" + std::to_string(Shape::kSizeX) + "x" + std::to_string(Shape::kSizeY) + "x" + std::to_string(Shape::kSizeZ);
+	World<Shape> world;
+	auto input = std::make_unique<mesher::BasicInput<Shape>>(); // Too large for the stack with column chunks
+
+	const glm::ivec3 min = kRegionMin / World<Shape>::GetSize();
+	const glm::ivec3 max = kRegionMax / World<Shape>::GetSize();
+	std::vector<glm::ivec3> indices;
+	glm::ivec3 index;
+	for (index.z = min.z; index.z < max.z; ++index.z) {
+		for (index.y = min.y; index.y < max.y; ++index.y) {
+			for (index.x = min.x; index.x < max.x; ++index.x) {
+				indices.push_back(index);
+			}
+		}
+	}
+
+	// Every non-empty mesh is one draw call, chunks above the terrain are empty and left out
+	int draw_calls = 0;
+	long long quads = 0;
+	bench::Measure((name + "/mesh_region").c_str(), 3, 1, [&]() {
+		draw_calls = 0;
+		quads = 0;
+		for (const glm::ivec3& i : indices) {
+			if (!world.GetChunk(i)) {
+				continue;
+			}
+			mesher::Gather(world.GetNeighborhood(i), input.get());
+			auto mesh = mesher::GenerateMesh(*input);
+			draw_calls += mesh->indices.empty() ? 0 : 1;
+			quads += (long long)mesh->indices.size() / 6;
+		}
+	});
+	std::cout << "[Benchmark] name=" << name << ", " <<
+		"chunks=" << indices.size() << ", " <<
+		"draw_calls=" << draw_calls << ", " <<
+		"quads=" << quads << std::endl;
+
+	// A single block edit on the surface remeshes the whole chunk around it
+	const glm::ivec3 edited = glm::ivec3(glm::floor(glm::vec3(0.0f, (float)GetHeight(0, 0), 0.0f) / glm::vec3(World<Shape>::GetSize())));
+	const auto neighbors = world.GetNeighborhood(edited);
+	bench::Measure((name + "/remesh").c_str(), 15, 16, [&]() {
+		for (int i = 0; i < 16; ++i) {
+			mesher::Gather(neighbors, input.get());
+			auto mesh = mesher::GenerateMesh(*input);
+			bench::DoNotOptimize(mesh);
+		}
+	});
+}
+
+} // namespace
+
+int main() {
+	MeasureShape<Chunk::Shape>();
+	MeasureShape<LargeChunkShape>();
+	MeasureShape<ColumnChunkShape>();
+	return 0;
+}
@@ -0,0 +1,156 @@
+// Linear against Morton block layout, for the access patterns of meshing, ambient occlusion and light flood fills
+// Lighting itself is hard-wired to the game's layout, run light_benchmark with MINECRAFT_MORTON_CHUNKS on and off to compare it
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <src/world/chunk.h>
+#include <src/world/lighting.h>
+#include <src/world/mesher.h>
+#include <src/utils/morton.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+namespace {
+
+// Random caves, a fraction `solid` of the blocks is solid, the same blocks for every layout
+template<typename Shape>
+std::unique_ptr<BasicChunk<Shape>> MakeChunk(glm::ivec3 index, float solid) {
+	auto chunk = std::make_unique<BasicChunk<Shape>>(index);
+	std::mt19937 rng(index.x + 3 * index.y + 9 * index.z + 13);
+	std::bernoulli_distribution solid_dist(solid);
+	for (int z = 0; z < Shape::kSizeZ; ++z) {
+		for (int y = 0; y < Shape::kSizeY; ++y) {
+			for (int x = 0; x < Shape::kSizeX; ++x) {
+				chunk->SetBlock({ x, y, z }, solid_dist(rng) ? 1 : 0);
+			}
+		}
+	}
+	return chunk;
+}
+
+template<typename Shape>
+void MeasureLayout(const std::string& name) {
+	const auto chunk = MakeChunk<Shape>(glm::ivec3(0), 0.7f);
+
+	// Random single block lookups, mostly the cost of the index math
+	const int num_lookups = 1 << 16;
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<int> dist(0, Shape::kSizeX - 1);
+	std::vector<glm::ivec3> positions(num_lookups);
+	for (auto& pos : positions) {
+		pos = glm::ivec3(dist(rng), dist(rng), dist(rng));
+	}
+	bench::Measure((name + "/get_block_random").c_str(), 15, num_lookups, [&]() {
+		int solid = 0;
+		for (const auto& pos : positions) {
+			solid += chunk->GetBlock(pos);
+		}
+		bench::DoNotOptimize(solid);
+	});
+
+	// Ambient occlusion and smooth lighting read the 3x3x3 blocks around every exposed block
+	const int n = Shape::kSizeX;
+	bench::Measure((name + "/neighborhood").c_str(), 15, (n - 2) * (n - 2) * (n - 2), [&]() {
+		int solid = 0;
+		for (int z = 1; z < n - 1; ++z) {
+			for (int y = 1; y < n - 1; ++y) {
+				for (int x = 1; x < n - 1; ++x) {
+					for (int i = 0; i < 27; ++i) {
+						solid += chunk->GetBlock({ x + i % 3 - 1, y + i / 3 % 3 - 1, z + i / 9 - 1 });
+					}
+				}
+			}
+		}
+		bench::DoNotOptimize(solid);
+	});
+
+	// Breadth first flood fill through the air, stepping indices like Lighting::GetNeighbor
+	const auto open_chunk = MakeChunk<Shape>(glm::ivec3(0), 0.3f);
+	std::vector<uint8_t> level(Shape::kVolume);
+	std::vector<int> queue;
+	queue.reserve(Shape::kVolume);
+	int filled = 0;
+	bench::Measure((name + "/flood_fill").c_str(), 15, Shape::kVolume, [&]() {
+		std::fill(level.begin(), level.end(), 0);
+		queue.clear();
+		const int start = Shape::GetIndex(n / 2, n / 2, n / 2);
+		level[start] = light::kMaxLevel;
+		queue.push_back(start);
+		for (size_t head = 0; head < queue.size(); ++head) {
+			const int index = queue[head];
+			for (int side = 0; side < 6; ++side) {
+				const int axis = side / 2;
+				const int delta = side % 2 == 0 ? -1 : +1;
+				if (Shape::IsAtEdge(index, axis, delta)) {
+					continue;
+				}
+				const int neighbor = Shape::Step(index, axis, delta);
+				if (open_chunk->data_[neighbor] == 0 && level[neighbor] == 0) {
+					level[neighbor] = 1;
+					queue.push_back(neighbor);
+				}
+			}
+		}
+		filled = (int)queue.size();
+	});
+	std::cout << "[Benchmark] name=" << name << "/flood_fill, filled=" << filled << std::endl;
+
+	// Meshing, where only the gather reads the chunk layout
+	std::vector<std::unique_ptr<BasicChunk<Shape>>> chunks;
+	mesher::BasicNeighborhood<Shape> neighbors;
+	for (int i = 0; i < 27; ++i) {
+		chunks.push_back(MakeChunk<Shape>(glm::ivec3(i % 3 - 1, i / 3 % 3 - 1, i / 9 - 1), 0.7f));
+		neighbors[i] = chunks.back().get();
+	}
+	mesher::BasicInput<Shape> input;
+	bench::Measure((name + "/gather").c_str(), 15, 256, [&]() {
+		for (int i = 0; i < 256; ++i) {
+			mesher::Gather(neighbors, &input);
+			bench::DoNotOptimize(input.blocks[i]);
+		}
+	});
+	size_t quads = 0;
+	bench::Measure((name + "/gather_and_mesh").c_str(), 15, 64, [&]() {
+		for (int i = 0; i < 64; ++i) {
+			mesher::Gather(neighbors, &input);
+			auto mesh = mesher::GenerateMesh(input);
+			quads = mesh->indices.size() / 6;
+		}
+	});
+	std::cout << "[Benchmark] name=" << name << "/gather_and_mesh, quads=" << quads << std::endl;
+}
+
+} // namespace
+
+int main() {
+	// Index computation alone, for random positions inside a 16^3 chunk
+	const int num_positions = 1 << 16;
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<uint32_t> dist(0, 15);
+	std::vector<glm::uvec3> positions(num_positions);
+	for (auto& pos : positions) {
+		pos = glm::uvec3(dist(rng), dist(rng), dist(rng));
+	}
+	auto measure_encode = [&](const char* name, auto&& encode) {
+		bench::Measure(name, 15, num_positions, [&]() {
+			uint32_t sum = 0;
+			for (const auto& pos : positions) {
+				sum ^= encode(pos.x, pos.y, pos.z);
+				bench::DoNotOptimize(sum);
+			}
+		});
+	};
+	measure_encode("layout/encode/linear", [](uint32_t x, uint32_t y, uint32_t z) {
+		return (uint32_t)LinearChunkShape::GetIndex(x, y, z);
+	});
+	measure_encode("layout/encode/morton_table", morton::EncodeTable);
+#if defined(__BMI2__)
+	measure_encode("layout/encode/morton_pdep", morton::EncodePdep);
+#else
+	std::cout << "[Benchmark] name=layout/encode/morton_pdep, skipped (build with BMI2, e.g. -march=native)" << std::endl;
+#endif
+
+	MeasureLayout<LinearChunkShape>("layout/linear");
+	MeasureLayout<MortonChunkShape>("layout/morton");
+	return 0;
+}
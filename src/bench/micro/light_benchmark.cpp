@@ -0,0 +1,70 @@
+// Incremental light updates after block edits, and how long until the edit is visible in a lit mesh
+#include <string>
+#include <src/world/block.h>
+#include <src/world/chunk_manager.h>
+#include <src/world/lighting.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+namespace {
+
+// Every call applies `edits` block edits, which are undone by the next call
+template<typename F>
+void MeasureUpdates(const std::string& name, ChunkManager& chunk_manager, int edits, F&& edit) {
+	const Lighting::Stats start = chunk_manager.GetLighting().GetStats();
+	bool undo = false;
+	double ns = bench::Measure(name.c_str(), 15, edits, [&]() {
+		edit(undo);
+		undo = !undo;
+	});
+	chunk_manager.Update(glm::vec3(0.0f)); // Remesh, so the edits don't pile up
+	const Lighting::Stats& stats = chunk_manager.GetLighting().GetStats();
+	std::cout << "[Benchmark] name=" << name << ", " <<
+		"updates_per_s=" << 1e9 / ns << ", " <<
+		"changed_per_update=" << (double)(stats.changed - start.changed) / (double)(stats.updates - start.updates) << std::endl;
+}
+
+} // namespace
+
+int main() {
+	ChunkManager chunk_manager;
+	chunk_manager.SetBudget(bench::UnlimitedBudget());
+	chunk_manager.Update(glm::vec3(0.0f));
+	std::cout << "[Benchmark] name=light/load_region, chunks=" << chunk_manager.GetLighting().GetStats().chunks << std::endl;
+
+	// A light source on the ground, flooding a radius of 13 blocks
+	MeasureUpdates("light/lamp", chunk_manager, 1, [&](bool undo) {
+		chunk_manager.SetBlock({ 3, 0, 3 }, undo ? 0 : block::kLamp);
+	});
+
+	// A 9x9 roof over open ground, the sky light below it is removed and refilled from the sides
+	MeasureUpdates("light/roof", chunk_manager, 81, [&](bool undo) {
+		for (int z = -4; z <= 4; ++z) {
+			for (int x = -4; x <= 4; ++x) {
+				chunk_manager.SetBlock({ x, 6, z }, undo ? 0 : 1);
+			}
+		}
+	});
+
+	// A vertical shaft dug into the ground across a chunk border, sky light falls down it
+	MeasureUpdates("light/shaft", chunk_manager, 24, [&](bool undo) {
+		for (int y = -1; y >= -24; --y) {
+			chunk_manager.SetBlock({ 7, y, 7 }, undo ? 1 : 0);
+		}
+	});
+
+	// Edit to remeshed, lit geometry, including the neighbouring chunks the light spreads into
+	chunk_manager.ResetEditStats();
+	bool undo = false;
+	bench::Measure("light/edit_to_mesh", 15, 1, [&]() {
+		chunk_manager.SetBlock({ 15, 0, 15 }, undo ? 0 : block::kLamp);
+		chunk_manager.Update(glm::vec3(0.0f));
+		undo = !undo;
+	});
+	const ChunkManager::EditStats& stats = chunk_manager.GetEditStats();
+	std::cout << "[Benchmark] name=light/edit_to_mesh, " <<
+		"remeshes_per_edit=" << (float)stats.remeshes / stats.edits << ", " <<
+		"latency_avg=" << stats.total_latency_ms / stats.remeshes << "ms, " <<
+		"latency_max=" << stats.max_latency_ms << "ms" << std::endl;
+
+	return 0;
+}
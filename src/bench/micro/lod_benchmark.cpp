@@ -0,0 +1,92 @@
+// Level of detail tiles: generation cost, and view distance against triangle count
+#include <string>
+#include <src/world/chunk_manager.h>
+#include <src/world/chunk.h>
+#include <src/world/lod.h>
+#include <src/world/mesher.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+namespace {
+
+const ChunkMesh* GetMesh(const std::unique_ptr<Chunk>& chunk) {
+	return chunk->mesh_.get();
+}
+
+const ChunkMesh* GetMesh(const std::shared_ptr<const ChunkMesh>& mesh) {
+	return mesh.get();
+}
+
+// Quads of the meshes inside the region, like the meshes that are drawn
+template<typename Map>
+long long CountQuads(const Map& meshes, const LoadRegion& region, glm::ivec3 center) {
+	long long quads = 0;
+	for (const auto& [index, value] : meshes) {
+		const ChunkMesh* mesh = GetMesh(value);
+		if (mesh && region.Contains(index - center)) {
+			quads += (long long)mesh->indices.size() / 6;
+		}
+	}
+	return quads;
+}
+
+} // namespace
+
+int main() {
+	// A surface tile of every level, generated and meshed from scratch
+	mesher::Input input;
+	for (int level = 1; level <= LodManager::kNumLevels; ++level) {
+		const std::string name = "lod/level_" + std::to_string(level);
+		bench::Measure((name + "/generate").c_str(), 15, 64, [&]() {
+			for (int i = 0; i < 64; ++i) {
+				LodManager::GenerateInput(level, glm::ivec3(i, -1, 0), &input);
+				bench::DoNotOptimize(input.blocks[i]);
+			}
+		});
+		bench::Measure((name + "/mesh").c_str(), 15, 64, [&]() {
+			for (int i = 0; i < 64; ++i) {
+				auto mesh = mesher::GenerateMesh(input);
+				bench::DoNotOptimize(mesh);
+			}
+		});
+	}
+
+	// Everything around the origin, without budgets
+	ChunkManager chunk_manager;
+	chunk_manager.SetBudget(bench::UnlimitedBudget());
+	chunk_manager.Update(glm::vec3(0.0f));
+
+	LodManager lod_manager;
+	LodManager::Budget lod_budget;
+	lod_budget.max_meshes = 1 << 30;
+	lod_budget.max_time_us = 0.0f;
+	lod_manager.SetBudget(lod_budget);
+	lod_manager.Update(glm::vec3(0.0f), chunk_manager.GetLoadRegion(), chunk_manager.GetCenter());
+
+	// View distance is the horizontal radius of each level's region, which is covered in every direction
+	const long long full_detail_quads = CountQuads(chunk_manager.GetChunks(), chunk_manager.GetLoadRegion(), chunk_manager.GetCenter());
+	const int full_detail_distance = chunk_manager.GetLoadRegion().radius * Chunk::kSize;
+	std::cout << "[Benchmark] name=lod/region, level=0, " <<
+		"view_distance=" << full_detail_distance << ", " <<
+		"chunks=" << chunk_manager.GetChunks().size() << ", " <<
+		"quads=" << full_detail_quads << std::endl;
+
+	long long total_quads = full_detail_quads;
+	int view_distance = full_detail_distance;
+	for (int level = 1; level <= LodManager::kNumLevels; ++level) {
+		long long quads = CountQuads(lod_manager.GetTiles(level), lod_manager.GetRegion(level), lod_manager.GetCenter(level));
+		total_quads += quads;
+		view_distance = lod_manager.GetRegion(level).radius * LodManager::GetTileSize(level);
+		std::cout << "[Benchmark] name=lod/region, level=" << level << ", " <<
+			"view_distance=" << view_distance << ", " <<
+			"tiles=" << lod_manager.GetTiles(level).size() << ", " <<
+			"quads=" << quads << std::endl;
+	}
+
+	// Chunks at full detail out to the same distance, estimated from the quads per area, since only the surface has faces
+	const float distance_ratio = (float)view_distance / (float)full_detail_distance;
+	std::cout << "[Benchmark] name=lod/region, " <<
+		"total_quads=" << total_quads << ", " <<
+		"full_detail_quads_estimate=" << (long long)(full_detail_quads * distance_ratio * distance_ratio) << std::endl;
+
+	return 0;
+}
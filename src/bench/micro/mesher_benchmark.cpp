@@ -0,0 +1,175 @@
+// Chunk meshing for a few representative block layouts
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <string>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include <src/world/block.h>
+#include <src/world/chunk.h>
+#include <src/world/mesher.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+// Counts heap allocations, so the number needed per mesh can be reported
+std::atomic<long long> num_allocations = 0;
+
+void* operator new(size_t size) {
+	++num_allocations;
+	if (void* ptr = std::malloc(size > 0 ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace {
+
+// Meshes the center chunk of a 3x3x3 neighbourhood, so borders are culled and occluded like in game
+struct Neighborhood {
+	std::vector<std::unique_ptr<Chunk>> chunks; // In mesher::GetNeighborIndex order
+	mesher::Neighborhood neighbors;
+
+	template<typename F>
+	explicit Neighborhood(F&& fill) {
+		for (int z = -1; z <= 1; ++z) {
+			for (int y = -1; y <= 1; ++y) {
+				for (int x = -1; x <= 1; ++x) {
+					auto chunk = std::make_unique<Chunk>(glm::ivec3(x, y, z));
+					for (int i = 0; i < Chunk::kVolume; ++i) {
+						chunk->data_[i] = fill(chunk->index_, i);
+					}
+					neighbors[mesher::GetNeighborIndex({ x, y, z })] = chunk.get();
+					chunks.push_back(std::move(chunk));
+				}
+			}
+		}
+	}
+};
+
+void MeasureMesher(const std::string& name, const Neighborhood& neighborhood) {
+	mesher::Input input;
+	mesher::Gather(neighborhood.neighbors, &input);
+
+	// Steady state, the per-thread scratch memory already exists
+	{
+		auto mesh = mesher::GenerateMesh(input);
+		long long allocations_start = num_allocations;
+		for (int i = 0; i < 16; ++i) {
+			mesh = mesher::GenerateMesh(input);
+		}
+		std::cout << std::fixed << std::setprecision(1) << "[Benchmark] name=" << name << "/allocations, per_mesh=" << (num_allocations - allocations_start) / 16.0 << std::endl;
+	}
+
+	const int chunks_per_repeat = 64;
+	bench::Measure(name.c_str(), 15, chunks_per_repeat, [&]() {
+		for (int i = 0; i < chunks_per_repeat; ++i) {
+			auto mesh = mesher::GenerateMesh(input);
+			bench::DoNotOptimize(mesh);
+		}
+	});
+
+	// Throughput with one mesher per hardware thread, inputs are read only and shared
+	const int num_threads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	bench::Measure((name + "/threads_" + std::to_string(num_threads)).c_str(), 15, num_threads * chunks_per_repeat, [&]() {
+		std::vector<std::thread> threads;
+		for (int t = 0; t < num_threads; ++t) {
+			threads.emplace_back([&]() {
+				for (int i = 0; i < chunks_per_repeat; ++i) {
+					auto mesh = mesher::GenerateMesh(input);
+					bench::DoNotOptimize(mesh);
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	});
+}
+
+} // namespace
+
+int main() {
+	// Half of the chunk solid, only the top layer of faces is visible
+	Neighborhood surface([](glm::ivec3 index, int i) -> uint8_t {
+		int y = Chunk::Shape::GetCoord(i, 1) + index.y * Chunk::kSize;
+		return y < Chunk::kSize / 2 ? 1 : 0;
+	});
+	MeasureMesher("mesher/surface", surface);
+
+	// Copying the chunk and its borders into the mesher input
+	mesher::Input input;
+	bench::Measure("mesher/gather", 15, 1024, [&]() {
+		for (int i = 0; i < 1024; ++i) {
+			mesher::Gather(surface.neighbors, &input);
+			bench::DoNotOptimize(input.blocks[i]);
+		}
+	});
+
+	// Every other block solid, the worst case for face count
+	Neighborhood checkerboard([](glm::ivec3 index, int i) -> uint8_t {
+		int x = Chunk::Shape::GetCoord(i, 0);
+		int y = Chunk::Shape::GetCoord(i, 1);
+		int z = Chunk::Shape::GetCoord(i, 2);
+		return (x + y + z) % 2 == 0 ? 1 : 0;
+	});
+	MeasureMesher("mesher/checkerboard", checkerboard);
+
+	// Glass and leaves alternating, the shared faces of different non-opaque blocks are all kept, every side of every block
+	Neighborhood glass_leaves([](glm::ivec3 index, int i) -> uint8_t {
+		int x = Chunk::Shape::GetCoord(i, 0);
+		int y = Chunk::Shape::GetCoord(i, 1);
+		int z = Chunk::Shape::GetCoord(i, 2);
+		return (x + y + z) % 2 == 0 ? block::kGlass : block::kLeaves;
+	});
+	MeasureMesher("mesher/glass_leaves", glass_leaves);
+	mesher::Gather(glass_leaves.neighbors, &input);
+	auto glass_leaves_mesh = mesher::GenerateMesh(input);
+	std::cout << "[Benchmark] name=mesher/glass_leaves, quads=" << glass_leaves_mesh->indices.size() / 6 << ", max_quads=" << 6 * Chunk::kVolume << std::endl;
+
+	// Random caves, fixed seed
+	std::mt19937 rng(0);
+	std::bernoulli_distribution solid_dist(0.7);
+	Neighborhood noise([&](glm::ivec3, int) -> uint8_t {
+		return solid_dist(rng) ? 1 : 0;
+	});
+	MeasureMesher("mesher/random70", noise);
+
+	// Glass walls standing in water, every quad of the mesh after the stone floor is cutout or translucent
+	Neighborhood pond([](glm::ivec3 index, int i) -> uint8_t {
+		int x = Chunk::Shape::GetCoord(i, 0);
+		int y = Chunk::Shape::GetCoord(i, 1) + index.y * Chunk::kSize;
+		if (y < 4) {
+			return block::kStone;
+		}
+		if (y < 12) {
+			return x % 4 == 0 ? block::kGlass : block::kWater;
+		}
+		return block::kAir;
+	});
+	MeasureMesher("mesher/pond", pond);
+
+	// Resorting the translucent faces, done for every chunk in view once the camera enters another block
+	mesher::Gather(pond.neighbors, &input);
+	auto pond_mesh = mesher::GenerateMesh(input);
+	std::vector<uint32_t> sorted;
+	bench::Measure("mesher/sort_translucent", 15, 64, [&]() {
+		for (int i = 0; i < 64; ++i) {
+			mesher::SortTranslucent(*pond_mesh, glm::vec3(0.5f * i, 20.0f, 8.0f), &sorted);
+			bench::DoNotOptimize(sorted.data());
+		}
+	});
+	std::cout << "[Benchmark] name=mesher/sort_translucent, quads=" << sorted.size() / 6 << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include <src/world/chunk_manager.h>
+
+// Minimal harness for the standalone benchmark executables
+// Every case runs a fixed amount of work several times and reports the minimum and median,
+// which are far more stable between runs than the mean
+namespace bench {
+
+// Keeps the compiler from optimizing away results that are otherwise unused
+template<typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+// Unbudgeted, so a single update loads, lights and meshes the whole region
+inline ChunkManager::Budget UnlimitedBudget() {
+	ChunkManager::Budget budget;
+	budget.max_loads = 1 << 30;
+	budget.max_unloads = 1 << 30;
+	budget.max_remeshes = 1 << 30;
+	budget.max_time_us = 0.0f;
+	return budget;
+}
+
+// Calls fn() `repeats` times, where each call performs `ops` operations
+// Returns the median time per operation in nanoseconds
+template<typename F>
+double Measure(const char* name, int repeats, long long ops, F&& fn) {
+	fn(); // Warm up caches and allocators
+
+	std::vector<double> ns_per_op(repeats);
+	for (int i = 0; i < repeats; ++i) {
+		const auto time_start = std::chrono::steady_clock::now();
+		fn();
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - time_start).count();
+		ns_per_op[i] = ns / (double)ops;
+	}
+	std::sort(ns_per_op.begin(), ns_per_op.end());
+
+	std::cout << std::fixed << std::setprecision(1) << "[Benchmark] " <<
+		"name=" << name << ", " <<
+		"ops=" << ops << ", " <<
+		"repeats=" << repeats << ", " <<
+		"min=" << ns_per_op.front() << "ns/op, " <<
+		"median=" << ns_per_op[repeats / 2] << "ns/op" << std::endl;
+	return ns_per_op[repeats / 2];
+}
+
+} // namespace bench
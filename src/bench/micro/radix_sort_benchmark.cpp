@@ -0,0 +1,53 @@
+// Ordering the drawn chunks by distance every frame: radix sort on quantized distance against std::sort
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include <src/world/load_region.h>
+#include <src/utils/radix_sort.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+int main() {
+	const glm::vec3 eye(5.3f, 7.9f, 12.1f); // Somewhere inside the center chunk
+	for (int radius : { 4, 8, 16, 24 }) { // Up to the 65536 draws the index bits can address
+		LoadRegion region;
+		region.radius = radius;
+		region.height = radius / 2;
+		const std::vector<glm::ivec3> offsets = region.GetOffsets();
+		std::vector<float> distances(offsets.size());
+		for (size_t i = 0; i < offsets.size(); ++i) {
+			distances[i] = glm::length((glm::vec3(offsets[i]) + 0.5f) * 16.0f - eye);
+		}
+		const std::string name = "radix_sort/radius_" + std::to_string(radius);
+		const int count = (int)offsets.size();
+
+		// Same as GameState::SortNearestFirst, quarter block distance above the draw index
+		std::vector<uint32_t> keys(count), scratch(count);
+		bench::Measure((name + "/radix").c_str(), 31, count, [&]() {
+			for (int i = 0; i < count; ++i) {
+				keys[i] = ((uint32_t)std::min(4.0f * distances[i], 65535.0f) << 16) | (uint32_t)i;
+			}
+			radix::Sort(keys.data(), scratch.data(), keys.size(), 2);
+			bench::DoNotOptimize(keys.data());
+		});
+
+		std::vector<std::pair<float, int>> pairs(count);
+		bench::Measure((name + "/std_sort").c_str(), 31, count, [&]() {
+			for (int i = 0; i < count; ++i) {
+				pairs[i] = { distances[i], i };
+			}
+			std::sort(pairs.begin(), pairs.end());
+			bench::DoNotOptimize(pairs.data());
+		});
+
+		// Quantization only swaps draws closer together than a quarter block
+		float max_inversion = 0.0f;
+		for (int i = 1; i < count; ++i) {
+			max_inversion = std::max(max_inversion, distances[keys[i - 1] & 0xFFFF] - distances[keys[i] & 0xFFFF]);
+		}
+		std::cout << "[Benchmark] name=" << name << ", draws=" << count << ", max_inversion=" << max_inversion << std::endl;
+	}
+	return 0;
+}
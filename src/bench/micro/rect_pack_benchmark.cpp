@@ -0,0 +1,35 @@
+// Font atlas packing
+#include <random>
+#include <vector>
+#include <src/utils/rect_pack.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+namespace {
+
+void MeasureRowPacking(const char* name, int num_rects, int atlas_size, unsigned int seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> size_dist(8, 48);
+	std::vector<rect_pack::Rectangle> input(num_rects);
+	for (int i = 0; i < num_rects; ++i) {
+		input[i] = { i, size_dist(rng), size_dist(rng), 0, 0 };
+	}
+
+	// Packing sorts in place, so every run starts from a fresh copy
+	std::vector<rect_pack::Rectangle> rects;
+	const int packs_per_repeat = 16;
+	bench::Measure(name, 15, packs_per_repeat, [&]() {
+		for (int i = 0; i < packs_per_repeat; ++i) {
+			rects = input;
+			bool packed = rect_pack::RowPacking(atlas_size, atlas_size, rects);
+			bench::DoNotOptimize(packed);
+		}
+	});
+}
+
+} // namespace
+
+int main() {
+	MeasureRowPacking("rect_pack/row_128", 128, 1024, 0);
+	MeasureRowPacking("rect_pack/row_1024", 1024, 2048, 0);
+	return 0;
+}
@@ -0,0 +1,43 @@
+// Signed distance field generation for font glyphs
+#include <cmath>
+#include <vector>
+#include <src/text/sdf.h>
+#include <src/bench/micro/micro_benchmark.h>
+
+namespace {
+
+// Ring shaped glyph, similar in coverage to an 'o'
+std::vector<uint8_t> CreateGlyph(int size) {
+	std::vector<uint8_t> bitmap(size * size);
+	float center = 0.5f * (float)size;
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			float r = std::hypot((float)x + 0.5f - center, (float)y + 0.5f - center) / center;
+			bitmap[y * size + x] = r > 0.5f && r < 0.9f ? 255 : 0;
+		}
+	}
+	return bitmap;
+}
+
+void MeasureSDF(const char* name, int glyph_size, int spread) {
+	std::vector<uint8_t> glyph = CreateGlyph(glyph_size);
+	int sdf_size = glyph_size + 2 * spread;
+	std::vector<uint8_t> sdf(sdf_size * sdf_size);
+
+	const int glyphs_per_repeat = 32;
+	bench::Measure(name, 15, glyphs_per_repeat, [&]() {
+		for (int i = 0; i < glyphs_per_repeat; ++i) {
+			sdf::GenerateSDF(spread, glyph.data(), glyph_size, glyph_size, sdf.data(), sdf_size, sdf_size);
+			bench::DoNotOptimize(sdf[sdf_size / 2]);
+		}
+	});
+}
+
+} // namespace
+
+int main() {
+	MeasureSDF("sdf/glyph_32_spread_4", 32, 4);
+	MeasureSDF("sdf/glyph_64_spread_8", 64, 8);
+	MeasureSDF("sdf/glyph_128_spread_8", 128, 8);
+	return 0;
+}
@@ -0,0 +1,41 @@
+#include "raycast_benchmark.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <chrono>
+#include <src/world/raycast.h>
+
+namespace bench {
+
+void RunRaycastBenchmark(const ChunkManager& chunk_manager, glm::vec3 origin, int num_rays, float max_distance, unsigned int seed) {
+	// Generate directions up front, so only the traversal is timed
+	std::mt19937 rng(seed);
+	std::normal_distribution<float> dist(0.0f, 1.0f);
+	std::vector<glm::vec3> directions(num_rays);
+	for (auto& dir : directions) {
+		do {
+			dir = glm::vec3(dist(rng), dist(rng), dist(rng));
+		} while (dir == glm::vec3(0.0f));
+	}
+
+	int num_hits = 0;
+	float distance_sum = 0.0f;
+	const auto time_start = std::chrono::steady_clock::now();
+	for (const auto& dir : directions) {
+		raycast::Hit hit;
+		if (raycast::CastRay(chunk_manager, origin, dir, max_distance, &hit)) {
+			++num_hits;
+			distance_sum += hit.distance;
+		}
+	}
+	float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - time_start).count();
+
+	std::cout << "[Raycast benchmark] " <<
+		"rays=" << num_rays << ", " <<
+		"hits=" << num_hits << ", " <<
+		"avg_hit_distance=" << (num_hits > 0 ? distance_sum / num_hits : 0.0f) << ", " <<
+		"rays/s=" << (seconds > 0.0f ? num_rays / seconds : 0.0f) << std::endl;
+}
+
+} // namespace bench
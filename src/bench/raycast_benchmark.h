@@ -0,0 +1,12 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+class ChunkManager;
+
+namespace bench {
+
+// Cast rays in random directions from origin and report throughput in rays per second
+void RunRaycastBenchmark(const ChunkManager& chunk_manager, glm::vec3 origin, int num_rays, float max_distance, unsigned int seed = 0);
+
+} // namespace bench
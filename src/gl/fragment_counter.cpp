@@ -0,0 +1,71 @@
+#include "fragment_counter.h"
+
+#include <algorithm>
+
+FragmentCounter::FragmentCounter(int num_passes) :
+	num_passes_(num_passes),
+	queries_(kLatency * num_passes),
+	issued_(kLatency * num_passes, 0),
+	invocations_(num_passes, 0)
+{
+	glGenQueries((GLsizei)queries_.size(), queries_.data());
+}
+
+FragmentCounter::~FragmentCounter() {
+	glDeleteQueries((GLsizei)queries_.size(), queries_.data());
+}
+
+void FragmentCounter::BeginFrame() {
+	int frame = (int)(num_frames_++ % kLatency);
+	if (pending_[frame] && !Resolve(frame)) {
+		frame_ = -1; // Skipped instead of stalling, the GPU is too far behind
+		return;
+	}
+	frame_ = frame;
+	std::fill_n(issued_.begin() + frame * num_passes_, num_passes_, 0);
+}
+
+void FragmentCounter::Begin(int pass) {
+	if (frame_ < 0) {
+		return;
+	}
+	glBeginQuery(GL_FRAGMENT_SHADER_INVOCATIONS, queries_[frame_ * num_passes_ + pass]);
+}
+
+void FragmentCounter::End(int pass) {
+	if (frame_ < 0) {
+		return;
+	}
+	glEndQuery(GL_FRAGMENT_SHADER_INVOCATIONS);
+	issued_[frame_ * num_passes_ + pass] = 1;
+	pending_[frame_] = true;
+}
+
+uint64_t FragmentCounter::GetInvocations(int pass) const {
+	return invocations_[pass];
+}
+
+bool FragmentCounter::Resolve(int frame) {
+	const uint8_t* issued = &issued_[frame * num_passes_];
+	const GLuint* queries = &queries_[frame * num_passes_];
+	for (int pass = 0; pass < num_passes_; ++pass) {
+		if (!issued[pass]) {
+			continue;
+		}
+		GLint available = 0;
+		glGetQueryObjectiv(queries[pass], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			return false;
+		}
+	}
+
+	for (int pass = 0; pass < num_passes_; ++pass) {
+		if (issued[pass]) {
+			GLuint64 invocations = 0;
+			glGetQueryObjectui64v(queries[pass], GL_QUERY_RESULT, &invocations);
+			invocations_[pass] = invocations;
+		}
+	}
+	pending_[frame] = false;
+	return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+
+// Per-pass fragment shader invocations from pipeline statistics queries
+// Fragments rejected by the early depth test are never shaded, so this measures overdraw
+// Results are read a few frames late like GpuTimer, passes can't overlap since queries of one target don't nest
+class FragmentCounter {
+public:
+	FragmentCounter(int num_passes);
+	~FragmentCounter();
+
+	// Call once per frame before any pass, resolves the oldest buffered frame
+	void BeginFrame();
+	void Begin(int pass);
+	void End(int pass);
+
+	uint64_t GetInvocations(int pass) const; // Of the latest resolved frame
+
+private:
+	bool Resolve(int frame);
+
+private:
+	static inline constexpr int kLatency = 3; // Frames in flight
+
+	int num_passes_;
+	std::vector<GLuint> queries_; // Per pass per frame
+	std::vector<uint8_t> issued_;
+	bool pending_[kLatency] = {};
+	int frame_ = -1; // Current slot, -1 if no queries are issued this frame
+
+	std::vector<uint64_t> invocations_;
+	uint64_t num_frames_ = 0;
+
+};
@@ -0,0 +1,46 @@
+#include "framebuffer.h"
+
+#include <stdexcept>
+
+Framebuffer::Framebuffer(int width, int height) {
+	width_ = width;
+	height_ = height;
+
+	glGenRenderbuffers(1, &color_rbo_);
+	glBindRenderbuffer(GL_RENDERBUFFER, color_rbo_);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &depth_rbo_);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth_rbo_);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &fbo_);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_rbo_);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_rbo_);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		throw std::runtime_error("Failed to create framebuffer");
+	}
+}
+
+Framebuffer::~Framebuffer() {
+	glDeleteFramebuffers(1, &fbo_);
+	glDeleteRenderbuffers(1, &color_rbo_);
+	glDeleteRenderbuffers(1, &depth_rbo_);
+}
+
+void Framebuffer::Bind() const {
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+}
+
+int Framebuffer::GetWidth() const {
+	return width_;
+}
+
+int Framebuffer::GetHeight() const {
+	return height_;
+}
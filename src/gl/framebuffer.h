@@ -0,0 +1,21 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Offscreen render target with color and depth renderbuffers
+class Framebuffer {
+public:
+	Framebuffer(int width, int height);
+	~Framebuffer();
+
+	void Bind() const;
+
+	int GetWidth() const;
+	int GetHeight() const;
+
+private:
+	GLuint fbo_, color_rbo_, depth_rbo_;
+	int width_;
+	int height_;
+
+};
@@ -0,0 +1,103 @@
+#include "gpu_timer.h"
+
+#include <algorithm>
+#include <src/utils/profiler.h>
+
+GpuTimer::GpuTimer(std::initializer_list<const char*> pass_names) :
+	pass_names_(pass_names),
+	queries_(kLatency * 2 * pass_names.size()),
+	issued_(kLatency * pass_names.size(), 0),
+	milliseconds_(pass_names.size(), 0.0f)
+{
+	glGenQueries((GLsizei)queries_.size(), queries_.data());
+
+	// Both clocks are read back to back, which is close enough to line up zones in the trace
+	GLint64 gpu_ns = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpu_ns);
+	gpu_to_cpu_ns_ = (int64_t)profiler::GetTimestamp() - (int64_t)gpu_ns;
+}
+
+GpuTimer::~GpuTimer() {
+	glDeleteQueries((GLsizei)queries_.size(), queries_.data());
+}
+
+void GpuTimer::BeginFrame() {
+	int frame = (int)(num_frames_++ % kLatency);
+	if (pending_[frame] && !Resolve(frame)) {
+		// The GPU is more than kLatency frames behind, skip timing this frame instead of stalling
+		frame_ = -1;
+		++dropped_frames_;
+		return;
+	}
+	frame_ = frame;
+	std::fill_n(issued_.begin() + frame * pass_names_.size(), pass_names_.size(), 0);
+}
+
+void GpuTimer::Begin(int pass) {
+	if (frame_ < 0) {
+		return;
+	}
+	glQueryCounter(GetQuery(frame_, pass, 0), GL_TIMESTAMP);
+}
+
+void GpuTimer::End(int pass) {
+	if (frame_ < 0) {
+		return;
+	}
+	glQueryCounter(GetQuery(frame_, pass, 1), GL_TIMESTAMP);
+	issued_[frame_ * pass_names_.size() + pass] = 1;
+	pending_[frame_] = true;
+}
+
+int GpuTimer::GetNumPasses() const {
+	return (int)pass_names_.size();
+}
+
+const char* GpuTimer::GetPassName(int pass) const {
+	return pass_names_[pass];
+}
+
+float GpuTimer::GetMilliseconds(int pass) const {
+	return milliseconds_[pass];
+}
+
+uint64_t GpuTimer::GetDroppedFrames() const {
+	return dropped_frames_;
+}
+
+GLuint GpuTimer::GetQuery(int frame, int pass, int end) const {
+	return queries_[2 * (frame * pass_names_.size() + pass) + end];
+}
+
+bool GpuTimer::Resolve(int frame) {
+	const int num_passes = (int)pass_names_.size();
+	const uint8_t* issued = &issued_[frame * num_passes];
+	for (int pass = 0; pass < num_passes; ++pass) {
+		if (!issued[pass]) {
+			continue;
+		}
+		GLint available = 0;
+		glGetQueryObjectiv(GetQuery(frame, pass, 1), GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			return false;
+		}
+	}
+
+	for (int pass = 0; pass < num_passes; ++pass) {
+		if (!issued[pass]) {
+			continue;
+		}
+		GLuint64 start_ns = 0, end_ns = 0;
+		glGetQueryObjectui64v(GetQuery(frame, pass, 0), GL_QUERY_RESULT, &start_ns);
+		glGetQueryObjectui64v(GetQuery(frame, pass, 1), GL_QUERY_RESULT, &end_ns);
+		milliseconds_[pass] = (float)(end_ns - start_ns) * 1e-6f;
+
+#ifdef PROFILING
+		int64_t start = std::max<int64_t>((int64_t)start_ns + gpu_to_cpu_ns_, 0);
+		int64_t end = std::max<int64_t>((int64_t)end_ns + gpu_to_cpu_ns_, start);
+		profiler::RecordGpuZone(pass_names_[pass], (uint64_t)start, (uint64_t)end);
+#endif
+	}
+	pending_[frame] = false;
+	return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <initializer_list>
+#include <glad/glad.h>
+
+// Per-pass GPU times from timestamp queries
+// Results are read a few frames late, so the CPU never waits for the GPU
+class GpuTimer {
+public:
+	// Names are not copied (string literals)
+	GpuTimer(std::initializer_list<const char*> pass_names);
+	~GpuTimer();
+
+	// Call once per frame before any pass, resolves the oldest buffered frame
+	void BeginFrame();
+	void Begin(int pass);
+	void End(int pass);
+
+	int GetNumPasses() const;
+	const char* GetPassName(int pass) const;
+	float GetMilliseconds(int pass) const; // Of the latest resolved frame
+	uint64_t GetDroppedFrames() const; // Frames that were not timed because the GPU was too far behind
+
+private:
+	GLuint GetQuery(int frame, int pass, int end) const;
+	bool Resolve(int frame);
+
+private:
+	static inline constexpr int kLatency = 3; // Frames in flight
+
+	std::vector<const char*> pass_names_;
+	std::vector<GLuint> queries_; // Begin and end timestamp per pass per frame
+	std::vector<uint8_t> issued_; // Passes that ran in each frame, not every pass runs every frame
+	bool pending_[kLatency] = {};
+	int frame_ = -1; // Current slot, -1 if no queries are issued this frame
+
+	int64_t gpu_to_cpu_ns_ = 0; // Offset from GPU timestamps to profiler timestamps
+	std::vector<float> milliseconds_;
+	uint64_t num_frames_ = 0;
+	uint64_t dropped_frames_ = 0;
+
+};
@@ -0,0 +1,75 @@
+#include "mesh.h"
+
+Mesh::Mesh(std::initializer_list<int> attribute_sizes) {
+	glGenVertexArrays(1, &vao_);
+	glGenBuffers(1, &vbo_);
+	glGenBuffers(1, &ebo_);
+
+	glBindVertexArray(vao_);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+
+	int stride = 0;
+	for (int size : attribute_sizes) {
+		stride += size;
+	}
+	GLuint index = 0;
+	int offset = 0;
+	for (int size : attribute_sizes) {
+		glEnableVertexAttribArray(index);
+		glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride * sizeof(GLfloat), (GLvoid*)(offset * sizeof(GLfloat)));
+		offset += size;
+		++index;
+	}
+
+	// VAOs store the following calls:
+	//   -For VBOs: glVertexAttribPointer and glEnableVertexAttribArray --> we CAN unbind VBOs
+	//   -For EBOs: glBindBuffer --> we CAN'T unbind EBOs
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+Mesh::~Mesh() {
+	glDeleteBuffers(1, &vbo_);
+	glDeleteBuffers(1, &ebo_);
+	glDeleteVertexArrays(1, &vao_);
+}
+
+void Mesh::Upload(const std::vector<float>& vertices, const std::vector<uint32_t>& indices) {
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+
+	// TODO: Experiment with GL_DYNAMIC_DRAW
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	num_indices_ = (GLsizei)indices.size();
+}
+
+void Mesh::UploadIndices(int first, const std::vector<uint32_t>& indices) {
+	// Direct state access, binding the EBO would attach it to whichever VAO is bound
+	glNamedBufferSubData(ebo_, first * sizeof(GLuint), indices.size() * sizeof(GLuint), indices.data());
+}
+
+void Mesh::Draw() const {
+	glBindVertexArray(vao_);
+	glDrawElements(GL_TRIANGLES, num_indices_, GL_UNSIGNED_INT, 0);
+}
+
+void Mesh::Draw(int first, int count) const {
+	glBindVertexArray(vao_);
+	glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (GLvoid*)(first * sizeof(GLuint)));
+}
+
+void Mesh::DrawIndirect(size_t offset) const {
+	glBindVertexArray(vao_);
+	glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const GLvoid*)offset);
+}
+
+int Mesh::GetNumIndices() const {
+	return (int)num_indices_;
+}
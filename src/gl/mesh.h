@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <initializer_list>
+#include <glad/glad.h>
+
+// Indexed triangle mesh with interleaved float vertex attributes
+class Mesh {
+public:
+	Mesh(std::initializer_list<int> attribute_sizes);
+	~Mesh();
+
+	void Upload(const std::vector<float>& vertices, const std::vector<uint32_t>& indices);
+	// Overwrites part of the uploaded indices, starting at index first
+	void UploadIndices(int first, const std::vector<uint32_t>& indices);
+	void Draw() const;
+	// Only count indices starting at index first
+	void Draw(int first, int count) const;
+	// DrawElementsIndirectCommand at a byte offset into the bound GL_DRAW_INDIRECT_BUFFER
+	void DrawIndirect(size_t offset) const;
+
+	int GetNumIndices() const;
+
+private:
+	GLuint vao_, vbo_, ebo_;
+	GLsizei num_indices_ = 0;
+
+};
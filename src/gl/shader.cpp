@@ -9,6 +9,10 @@ Shader::Shader(const std::string& vertex_path, const std::string& fragment_path)
 	id_ = gl::CreateProgram(vertex_path, fragment_path);
 }
 
+Shader::Shader(const std::string& compute_path) {
+	id_ = gl::CreateComputeProgram(compute_path);
+}
+
 Shader::~Shader() {
 	glDeleteProgram(id_);
 }
@@ -17,6 +21,10 @@ void Shader::Use() const {
 	glUseProgram(id_);
 }
 
+void Shader::SetInt(const char* name, int value) {
+	glUniform1i(glGetUniformLocation(id_, name), value);
+}
+
 void Shader::SetFloat(const char* name, float value) {
 	glUniform1f(glGetUniformLocation(id_, name), value);
 }
@@ -37,6 +45,49 @@ void Shader::SetMatrix4(const char* name, const glm::mat4& matrix) {
 	glUniformMatrix4fv(glGetUniformLocation(id_, name), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
+namespace {
+
+// Prints the log if linking or validation failed, name describes the program's shaders
+void LinkProgram(GLuint program, const std::string& name) {
+	glLinkProgram(program);
+	GLint is_linked;
+	glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+	if (is_linked == GL_FALSE) {
+		// Linking error
+		GLint log_length;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length);
+
+		GLchar* log = new GLchar[log_length];
+		glGetProgramInfoLog(program, log_length, &log_length, log);
+
+		std::cerr << "[PROGRAM LINKING ERROR] " << name << std::endl;
+		std::cerr << log << std::endl << std::endl;
+		delete[] log;
+	}
+	else {
+		// Linking success
+#ifdef DEBUG
+		glValidateProgram(program);
+		GLint is_valid;
+		glGetProgramiv(program, GL_VALIDATE_STATUS, &is_valid);
+		if (is_valid == GL_FALSE) {
+			// Validation error
+			GLint log_length;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length);
+
+			GLchar* log = new GLchar[log_length];
+			glGetProgramInfoLog(program, log_length, &log_length, log);
+
+			std::cerr << "[PROGRAM VALIDATION ERROR] " << name << std::endl;
+			std::cerr << log << std::endl << std::endl;
+			delete[] log;
+		}
+#endif
+	}
+}
+
+} // namespace
+
 namespace gl {
 
 	GLuint CreateShader(const std::string& file_path, GLenum shader_type) {
@@ -73,41 +124,7 @@ namespace gl {
 		glAttachShader(program, vertex_shader);
 		glAttachShader(program, fragment_shader);
 
-		glLinkProgram(program);
-		GLint is_linked;
-		glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
-		if (is_linked == GL_FALSE) {
-			// Linking error
-			GLint log_length;
-			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length);
-
-			GLchar* log = new GLchar[log_length];
-			glGetProgramInfoLog(program, log_length, &log_length, log);
-
-			std::cerr << "[PROGRAM LINKING ERROR] " << vertex_shader_path << ", " << fragment_shader_path << std::endl;
-			std::cerr << log << std::endl << std::endl;
-			delete[] log;
-		}
-		else {
-			// Linking success
-#ifdef DEBUG
-			glValidateProgram(program);
-			GLint is_valid;
-			glGetProgramiv(program, GL_VALIDATE_STATUS, &is_valid);
-			if (is_valid == GL_FALSE) {
-				// Validation error
-				GLint log_length;
-				glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length);
-
-				GLchar* log = new GLchar[log_length];
-				glGetProgramInfoLog(program, log_length, &log_length, log);
-
-				std::cerr << "[PROGRAM VALIDATION ERROR] " << vertex_shader_path << ", " << fragment_shader_path << std::endl;
-				std::cerr << log << std::endl << std::endl;
-				delete[] log;
-			}
-#endif
-		}
+		LinkProgram(program, vertex_shader_path + ", " + fragment_shader_path);
 
 		glDeleteShader(vertex_shader);
 		glDeleteShader(fragment_shader);
@@ -115,4 +132,16 @@ namespace gl {
 		return program;
 	}
 
+	GLuint CreateComputeProgram(const std::string& compute_shader_path) {
+		GLuint compute_shader = CreateShader(compute_shader_path, GL_COMPUTE_SHADER);
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, compute_shader);
+		LinkProgram(program, compute_shader_path);
+
+		glDeleteShader(compute_shader);
+
+		return program;
+	}
+
 }
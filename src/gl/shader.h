@@ -8,17 +8,20 @@ namespace gl {
 
 	GLuint CreateShader(const std::string& file_path, GLenum shader_type);
 	GLuint CreateProgram(const std::string& vertex_shader_path, const std::string& fragment_shader_path);
+	GLuint CreateComputeProgram(const std::string& compute_shader_path);
 
 }
 
 class Shader {
 public:
 	Shader(const std::string& vertex_path, const std::string& fragment_path);
+	explicit Shader(const std::string& compute_path); // Dispatched with glDispatchCompute after Use
 	~Shader();
 
 	void Use() const;
 
 	// Using `const char*` is much faster than `const string&`
+	void SetInt(const char* name, int value);
 	void SetFloat(const char* name, float value);
 	void SetVector2(const char* name, const glm::vec2& vector);
 	void SetVector3(const char* name, const glm::vec3& vector);
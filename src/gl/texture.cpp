@@ -1,10 +1,10 @@
 #include "texture.h"
 
 #include <iostream>
-#define STB_IMAGE_IMPLEMENTATION
+#include <algorithm>
 #define STB_IMAGE_WRITE_IMPLEMENTATION
-#include <stb_image.h>
 #include <stb_image_write.h>
+#include <src/utils/image.h>
 
 const int Texture::kFallbackWidth = 2;
 const int Texture::kFallbackHeight = 2;
@@ -18,19 +18,20 @@ Texture::Texture(int width, int height, int num_components, GLubyte* data, Textu
 }
 
 Texture::Texture(const std::string& file_path, TextureParams params) {
-    int width, height, num_components;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(file_path.c_str(), &width, &height, &num_components, 0);
+    std::unique_ptr<image::Image> image = image::Load(file_path, params.generate_mipmap_ ? params.max_level_ + 1 : 1);
 
-    if (data) {
-        Generate(width, height, num_components, data, params);
-        stbi_image_free(data);
+    if (image) {
+        Generate(*image, params);
     } else {
         std::cerr << "[ERROR] Can't load texture " << file_path << std::endl;
         Generate(kFallbackWidth, kFallbackHeight, GL_RGBA, (GLubyte*)kFallbackData, TextureParams(GL_REPEAT, GL_REPEAT, GL_LINEAR, GL_LINEAR));
     }
 }
 
+Texture::Texture(const image::Image& image, TextureParams params) {
+    Generate(image, params);
+}
+
 Texture::~Texture() {
 	glDeleteTextures(1, &id_);
 }
@@ -49,6 +50,7 @@ void Texture::Generate(int width, int height, int num_components, GLubyte* data,
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.min_filter_);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.mag_filter_);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, params.max_anisotropy_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, params.max_level_);
 
     GLuint format;
     switch (num_components_) {
@@ -70,6 +72,22 @@ void Texture::Generate(int width, int height, int num_components, GLubyte* data,
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+void Texture::Generate(const image::Image& image, TextureParams params) {
+    // Sampling past the last uploaded level would leave the texture incomplete
+    params.generate_mipmap_ = false;
+    params.max_level_ = std::min(params.max_level_, image.GetNumLevels() - 1);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Levels are tightly packed, small ones have rows of any length
+    Generate(image.GetWidth(), image.GetHeight(), image.num_components, (GLubyte*)image.GetPixels(0), params);
+
+    glBindTexture(GL_TEXTURE_2D, id_);
+    for (int level = 1; level < image.GetNumLevels(); ++level) {
+        const image::Level& info = image.levels[level];
+        glTexImage2D(GL_TEXTURE_2D, level, internal_format_, info.width, info.height, 0, internal_format_, GL_UNSIGNED_BYTE, image.GetPixels(level));
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    has_mipmap_ = image.GetNumLevels() > 1; // SubImage regenerates them on the GPU
+}
+
 int Texture::GetWidth() const {
     return width_;
 }
@@ -104,12 +122,13 @@ void Texture::SavePNG(const std::string& output_path) {
 }
 
 
-TextureParams::TextureParams(GLuint wrap_s, GLuint wrap_t, GLuint min_filter, GLuint mag_filter, bool generate_mipmap, float max_anisotropy) {
+TextureParams::TextureParams(GLuint wrap_s, GLuint wrap_t, GLuint min_filter, GLuint mag_filter, bool generate_mipmap, float max_anisotropy, int max_level) {
     wrap_s_ = wrap_s;
     wrap_t_ = wrap_t;
     min_filter_ = min_filter;
     mag_filter_ = mag_filter;
     generate_mipmap_ = generate_mipmap;
+    max_level_ = max_level;
 
     GLfloat max_supported_anisotropy;
     glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &max_supported_anisotropy);
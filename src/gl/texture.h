@@ -3,11 +3,14 @@
 #include <glad/glad.h>
 #include <string>
 
+namespace image {
+struct Image;
+}
 
 class TextureParams {
 public:
 	TextureParams() = default;
-	TextureParams(GLuint wrap_s, GLuint wrap_t, GLuint min_filter, GLuint mag_filter, bool generate_mipmap = false, float max_anisotropy = 1.0f);
+	TextureParams(GLuint wrap_s, GLuint wrap_t, GLuint min_filter, GLuint mag_filter, bool generate_mipmap = false, float max_anisotropy = 1.0f, int max_level = 1000);
 
 	GLuint wrap_s_ = GL_CLAMP_TO_EDGE;
 	GLuint wrap_t_ = GL_CLAMP_TO_EDGE;
@@ -15,11 +18,15 @@ public:
 	GLuint mag_filter_ = GL_LINEAR;
 	bool generate_mipmap_ = false;
 	float max_anisotropy_ = 1.0f;
+	int max_level_ = 1000; // Last mipmap level, lower for atlases so tiles don't blend into each other
 };
 
 class Texture {
 public:
+	// Mipmaps are generated on the CPU and cached with the decoded image, see image::Load
 	Texture(const std::string& file_path, TextureParams params = TextureParams());
+	// Uploads every level of the image, generate_mipmap is ignored since the image brings its own
+	Texture(const image::Image& image, TextureParams params = TextureParams());
 	Texture(int width, int height, int num_components, unsigned char* data, TextureParams params = TextureParams());
 	~Texture();
 
@@ -33,6 +40,7 @@ public:
 
 private:
 	void Generate(int width, int height, int num_components, GLubyte* data, TextureParams params);
+	void Generate(const image::Image& image, TextureParams params);
 
 private:
 	GLuint id_;
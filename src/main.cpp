@@ -1,18 +1,67 @@
 #include <iostream>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <src/window.h>
+#include <src/gl/framebuffer.h>
 #include <src/states/game_state.h>
 #include <src/utils/timer.h>
+#include <src/utils/fixed_timestep.h>
+#include <src/utils/profiler.h>
+
+int main(int argc, char** argv) {
+	// Options
+	// --headless               Hidden window without input, renders offscreen and runs the flythrough benchmark
+	// --flythrough <frames>    Run the flythrough benchmark on startup and quit once the report is written
+	// --seed <seed>            Seed of the flythrough path
+	// --farthest-first         Draw opaque geometry farthest first, to compare fragment counts against the default order
+	// --occlusion-culling      Cull chunks hidden behind others on the GPU, off by default until checked on more drivers
+	bool headless = false;
+	bool farthest_first = false;
+	bool occlusion_culling = false;
+	int flythrough_frames = 0;
+	unsigned int seed = 0;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--headless") {
+			headless = true;
+		} else if (arg == "--flythrough" && i + 1 < argc) {
+			flythrough_frames = std::atoi(argv[++i]);
+			if (flythrough_frames < 2) {
+				std::cerr << "[ERROR] --flythrough needs at least 2 frames" << std::endl;
+				return 1;
+			}
+		} else if (arg == "--seed" && i + 1 < argc) {
+			seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+		} else if (arg == "--farthest-first") {
+			farthest_first = true;
+		} else if (arg == "--occlusion-culling") {
+			occlusion_culling = true;
+		} else {
+			std::cerr << "[ERROR] Unknown argument " << arg << std::endl;
+			return 1;
+		}
+	}
+	if (headless && flythrough_frames <= 0) {
+		flythrough_frames = 3000; // Nothing else would end a headless run
+	}
 
-int main() {
 	// GLFW
+#ifdef GLFW_PLATFORM_NULL
+	if (headless && !std::getenv("DISPLAY") && !std::getenv("WAYLAND_DISPLAY")) {
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+	}
+#endif
 	if (!glfwInit()) {
 		throw std::runtime_error("Failed to initialize GLFW");
 	}
 
-	Window window("Minecraft");
+	Window window("Minecraft", headless);
 	glfwMakeContextCurrent(window.glfw_window_);
 	glfwSwapInterval(0); // Disable VSync
 
@@ -23,22 +72,79 @@ int main() {
 
 	glEnable(GL_MULTISAMPLE);
 
-	std::unique_ptr<State> state = std::make_unique<GameState>(&window);
+	// Sky instead of garbage while the game loads
+	if (!headless) {
+		glClearColor(0.5f, 0.675f, 0.85f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glfwSwapBuffers(window.glfw_window_);
+	}
+
+	// Hidden windows don't own their pixels, so headless runs draw into a framebuffer of the same size
+	std::unique_ptr<Framebuffer> offscreen;
+	if (headless) {
+		offscreen = std::make_unique<Framebuffer>(window.GetWidth(), window.GetHeight());
+	}
+
+	auto game_state = std::make_unique<GameState>(&window);
+	game_state->SetFarthestFirst(farthest_first);
+	game_state->SetOcclusionCulling(occlusion_culling);
+	if (flythrough_frames > 0) {
+		game_state->StartFlythrough(flythrough_frames, seed, true);
+	}
+	std::unique_ptr<State> state = std::move(game_state);
 	window.SetState(state.get());
 
+	// Render thread takes over the OpenGL context and draws frames produced by the main (simulation) thread
+	// Events have to be processed on the main thread
+	glfwMakeContextCurrent(nullptr);
+	std::atomic<bool> running = true;
+	std::thread render_thread([&]() {
+		PROFILE_THREAD("Render");
+		glfwMakeContextCurrent(window.glfw_window_);
+		if (offscreen) {
+			offscreen->Bind();
+		}
+		while (running) {
+			if (state->Render()) {
+				glfwPostEmptyEvent(); // Wakes the simulation thread, which waits for the frame to be picked up
+				PROFILE_SCOPE("glfwSwapBuffers");
+				glfwSwapBuffers(window.glfw_window_);
+			} else {
+				std::this_thread::yield();
+			}
+		}
+		glfwMakeContextCurrent(nullptr);
+	});
+
+	PROFILE_THREAD("Simulation");
 	Timer timer;
+	FixedTimestep timestep(State::kTickRate);
 
 	while (!glfwWindowShouldClose(window.glfw_window_)) {
+		// Nothing can be published until the render thread picks up the last frame, so sleep until then or until a tick is due
+		const float time_to_tick = timestep.GetTimeToNextTick() - timer.GetElapsedTime();
+		if (state->IsFramePending() && time_to_tick > 0.0f) {
+			PROFILE_SCOPE("glfwWaitEventsTimeout");
+			glfwWaitEventsTimeout(time_to_tick);
+		} else {
+			glfwPollEvents();
+		}
 		timer.Update();
 
-		state->Update(timer.GetDeltaTime());
-		state->Render();
-
-		glfwSwapBuffers(window.glfw_window_);
-		glfwPollEvents();
+		int num_ticks = timestep.Advance(timer.GetDeltaTime());
+		for (int i = 0; i < num_ticks; ++i) {
+			state->Tick(timestep.GetTickDeltaTime());
+		}
+		state->Update(timer.GetDeltaTime(), timestep);
 	}
 
+	running = false;
+	render_thread.join();
+
+	// Resources have to be released with the context current
+	glfwMakeContextCurrent(window.glfw_window_);
 	state = nullptr;
+	offscreen = nullptr;
 	glfwTerminate();
 
 	return 0;
@@ -0,0 +1,152 @@
+#include "physics.h"
+
+#include <cmath>
+#include <algorithm>
+#include <src/world/block.h>
+#include <src/world/chunk_manager.h>
+#include <src/world/chunk.h>
+
+namespace {
+
+// Tolerance for boxes resting exactly on a block boundary
+constexpr float kEpsilon = 1e-4f;
+
+struct AABB {
+	glm::vec3 min;
+	glm::vec3 max;
+};
+
+// Block lookups in a sweep are spatially coherent, so remember the last chunk instead of hashing every block
+class BlockCache {
+public:
+	BlockCache(const ChunkManager* chunk_manager) : chunk_manager_(chunk_manager) {}
+
+	bool IsSolid(glm::ivec3 pos) {
+		glm::ivec3 index = ChunkManager::GetChunkIndex(pos);
+		if (!chunk_ || index != index_) {
+			index_ = index;
+			chunk_ = chunk_manager_->GetChunk(index);
+			if (!chunk_) {
+				return true;
+			}
+		}
+		return block::IsSolid(chunk_->GetBlock(pos - index * Chunk::kSize));
+	}
+
+private:
+	const ChunkManager* chunk_manager_;
+	const Chunk* chunk_ = nullptr;
+	glm::ivec3 index_ = glm::ivec3(0);
+};
+
+// Returns how far the box can move along the axis before touching a solid block
+float SweepAxis(const AABB& box, int axis, float distance, BlockCache& blocks) {
+	if (distance == 0.0f) {
+		return 0.0f;
+	}
+
+	// Only blocks overlapped by the box on the other two axes can be hit
+	int u = (axis + 1) % 3;
+	int v = (axis + 2) % 3;
+	int u_min = (int)std::floor(box.min[u] + kEpsilon);
+	int u_max = (int)std::ceil(box.max[u] - kEpsilon) - 1;
+	int v_min = (int)std::floor(box.min[v] + kEpsilon);
+	int v_max = (int)std::ceil(box.max[v] - kEpsilon) - 1;
+
+	// Walk block layers from nearest to farthest, skipping blocks the box already intersects
+	int dir = distance > 0.0f ? 1 : -1;
+	int first, last;
+	if (dir > 0) {
+		first = (int)std::ceil(box.max[axis] - kEpsilon);
+		last = (int)std::floor(box.max[axis] + distance);
+	} else {
+		first = (int)std::floor(box.min[axis] + kEpsilon) - 1;
+		last = (int)std::floor(box.min[axis] + distance);
+	}
+
+	glm::ivec3 pos;
+	for (int layer = first; dir * (last - layer) >= 0; layer += dir) {
+		pos[axis] = layer;
+		for (pos[u] = u_min; pos[u] <= u_max; ++pos[u]) {
+			for (pos[v] = v_min; pos[v] <= v_max; ++pos[v]) {
+				if (blocks.IsSolid(pos)) {
+					if (dir > 0) {
+						return std::max(0.0f, (float)layer - box.max[axis]);
+					} else {
+						return std::min(0.0f, (float)(layer + 1) - box.min[axis]);
+					}
+				}
+			}
+		}
+	}
+	return distance;
+}
+
+void Translate(AABB& box, int axis, float distance) {
+	box.min[axis] += distance;
+	box.max[axis] += distance;
+}
+
+} // namespace
+
+Physics::Physics(const ChunkManager* chunk_manager) {
+	chunk_manager_ = chunk_manager;
+}
+
+void Physics::Step(PhysicsBody& body, float dt) const {
+	if (body.gravity) {
+		body.velocity.y = std::max(body.velocity.y - gravity_ * dt, -terminal_velocity_);
+	}
+
+	glm::vec3 half_size(body.size.x * 0.5f, 0.0f, body.size.z * 0.5f);
+	AABB start = { body.position - half_size, body.position + half_size };
+	start.max.y += body.size.y;
+
+	BlockCache blocks(chunk_manager_);
+	glm::vec3 motion = body.velocity * dt;
+
+	// Resolve one axis at a time, vertical first so that walking on the ground isn't blocked by it
+	AABB box = start;
+	glm::vec3 moved;
+	for (int axis : { 1, 0, 2 }) {
+		moved[axis] = SweepAxis(box, axis, motion[axis], blocks);
+		Translate(box, axis, moved[axis]);
+	}
+	bool on_ground = motion.y < 0.0f && moved.y > motion.y;
+
+	// Step up onto ledges when horizontal motion is blocked
+	bool blocked = moved.x != motion.x || moved.z != motion.z;
+	if (blocked && (body.on_ground || on_ground) && step_height_ > 0.0f) {
+		AABB step_box = start;
+		float up = SweepAxis(step_box, 1, step_height_, blocks);
+		Translate(step_box, 1, up);
+		glm::vec3 step_moved;
+		for (int axis : { 0, 2 }) {
+			step_moved[axis] = SweepAxis(step_box, axis, motion[axis], blocks);
+			Translate(step_box, axis, step_moved[axis]);
+		}
+		float down = SweepAxis(step_box, 1, std::min(motion.y, 0.0f) - up, blocks);
+		Translate(step_box, 1, down);
+
+		float dist2 = moved.x * moved.x + moved.z * moved.z;
+		float step_dist2 = step_moved.x * step_moved.x + step_moved.z * step_moved.z;
+		if (step_dist2 > dist2) {
+			box = step_box;
+			moved = glm::vec3(step_moved.x, step_box.min.y - start.min.y, step_moved.z);
+			on_ground = true;
+		}
+	}
+
+	// Cancel velocity on blocked axes
+	for (int axis = 0; axis < 3; ++axis) {
+		if (moved[axis] != motion[axis] && axis != 1) {
+			body.velocity[axis] = 0.0f;
+		}
+	}
+	if (on_ground || (motion.y > 0.0f && moved.y < motion.y)) {
+		body.velocity.y = 0.0f;
+	}
+
+	body.on_ground = on_ground;
+	body.position = glm::vec3((box.min.x + box.max.x) * 0.5f, box.min.y, (box.min.z + box.max.z) * 0.5f);
+}
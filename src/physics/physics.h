@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+class ChunkManager;
+
+struct PhysicsBody {
+	glm::vec3 position = { 0.0f, 0.0f, 0.0f }; // Center of the bottom face
+	glm::vec3 size = { 0.6f, 1.8f, 0.6f };
+	glm::vec3 velocity = { 0.0f, 0.0f, 0.0f };
+	bool gravity = true;
+	bool on_ground = false;
+};
+
+// Collision of axis-aligned boxes against solid blocks, unloaded chunks are treated as solid
+class Physics {
+public:
+	Physics(const ChunkManager* chunk_manager);
+
+	// Should be called at a fixed rate, so the results don't depend on the frame rate
+	void Step(PhysicsBody& body, float dt) const;
+
+public:
+	float gravity_ = 28.0f;
+	float terminal_velocity_ = 60.0f;
+	float step_height_ = 0.6f;
+
+private:
+	const ChunkManager* chunk_manager_;
+
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <src/world/load_region.h>
+
+struct ChunkMesh;
+class FlythroughBenchmark;
+
+// Immutable snapshot of everything the render thread needs to draw a frame
+struct Frame {
+	struct ChunkDraw {
+		glm::ivec3 index;
+		std::shared_ptr<const ChunkMesh> mesh;
+		// Replaces the mesh's translucent index range, back to front from the camera's block, null without translucent faces
+		std::shared_ptr<const std::vector<uint32_t>> translucent_indices;
+	};
+
+	// Tiles of one level of detail, drawn everywhere but inside the clip region covered by the finer level
+	struct LodLevel {
+		LoadRegion clip_region; // In cells of clip_cell_size blocks around clip_center
+		glm::ivec3 clip_center;
+		int clip_cell_size;
+		std::vector<ChunkDraw> tiles;
+	};
+
+	int width = 0;
+	int height = 0;
+	glm::mat4 proj_view_mat;
+	std::vector<ChunkDraw> chunks; // Nearest first
+	std::vector<LodLevel> lod_levels; // From level 1 up, tiles nearest first
+	bool farthest_first = false; // Draws opaque chunks and tiles in reverse, for comparing overdraw
+	bool occlusion_culling = false; // Chunks only, tiles are always drawn
+
+	bool show_debug_info = false;
+	std::string debug_text;
+
+	float sim_ms = 0.0f; // Simulation time spent on this frame, including ticks
+	int chunk_loads = 0; // Since the previous frame
+	int chunk_meshes = 0;
+
+	// Set while the flythrough benchmark is running
+	std::shared_ptr<FlythroughBenchmark> flythrough;
+	int flythrough_frame = -1;
+};
@@ -0,0 +1,229 @@
+#include "occlusion_culler.h"
+
+#include <iostream>
+#include <algorithm>
+#include <src/gl/shader.h>
+
+namespace {
+
+// Grows a buffer to at least size bytes, copying the old contents over if keep is set
+void Reserve(GLuint* buffer, size_t* capacity, size_t size, bool keep) {
+	if (size <= *capacity) {
+		return;
+	}
+	const size_t new_capacity = std::max({ 2 * *capacity, size, (size_t)256 });
+	GLuint new_buffer;
+	glCreateBuffers(1, &new_buffer);
+	glNamedBufferData(new_buffer, new_capacity, nullptr, GL_DYNAMIC_DRAW);
+	if (keep && *capacity > 0) {
+		glCopyNamedBufferSubData(*buffer, new_buffer, 0, 0, *capacity);
+	}
+	glDeleteBuffers(1, buffer);
+	*buffer = new_buffer;
+	*capacity = new_capacity;
+}
+
+GLuint GetNumGroups(int size, int group_size) {
+	return (GLuint)((size + group_size - 1) / group_size);
+}
+
+} // namespace
+
+OcclusionCuller::OcclusionCuller() {
+	depth_shader_ = std::make_unique<Shader>("data/shaders/basic.vert", "data/shaders/depth.frag");
+	hiz_copy_shader_ = std::make_unique<Shader>("data/shaders/hiz_copy.comp");
+	hiz_reduce_shader_ = std::make_unique<Shader>("data/shaders/hiz_reduce.comp");
+	cull_shader_ = std::make_unique<Shader>("data/shaders/cull.comp");
+
+	glCreateBuffers(1, &counter_buffer_);
+	glNamedBufferData(counter_buffer_, sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+	glCreateBuffers(kLatency, readback_buffers_);
+	for (GLuint buffer : readback_buffers_) {
+		glNamedBufferData(buffer, sizeof(GLuint), nullptr, GL_STREAM_READ);
+	}
+}
+
+OcclusionCuller::~OcclusionCuller() {
+	for (GLsync fence : fences_) {
+		if (fence) {
+			glDeleteSync(fence);
+		}
+	}
+	glDeleteBuffers(kLatency, readback_buffers_);
+	glDeleteBuffers(1, &counter_buffer_);
+	glDeleteBuffers(1, &command_buffer_);
+	glDeleteBuffers(1, &visibility_buffer_);
+	glDeleteBuffers(1, &chunk_buffer_);
+	glDeleteFramebuffers(1, &depth_framebuffer_);
+	glDeleteTextures(1, &depth_texture_);
+	glDeleteTextures(1, &hiz_texture_);
+}
+
+int OcclusionCuller::AllocateSlot() {
+	int slot;
+	if (!free_slots_.empty()) {
+		slot = free_slots_.back();
+		free_slots_.pop_back();
+	} else {
+		slot = num_slots_++;
+		fresh_.push_back(0);
+	}
+	fresh_[slot] = 1;
+	return slot;
+}
+
+void OcclusionCuller::FreeSlot(int slot) {
+	free_slots_.push_back(slot);
+}
+
+void OcclusionCuller::ClearChunks() {
+	chunks_.clear();
+}
+
+void OcclusionCuller::AddChunk(int slot, const glm::vec3& min, const glm::vec3& max, const std::array<uint32_t, block::kNumRenderTypes + 1>& index_offsets) {
+	GpuChunk& chunk = chunks_.emplace_back();
+	chunk.min = glm::vec4(min, 1.0f);
+	chunk.max = glm::vec4(max, 1.0f);
+	for (int type = 0; type < block::kNumRenderTypes; ++type) {
+		chunk.first[type] = index_offsets[type];
+		chunk.count[type] = index_offsets[type + 1] - index_offsets[type];
+	}
+	chunk.slot = (uint32_t)slot;
+	chunk.fresh = fresh_[slot];
+	fresh_[slot] = 0;
+}
+
+void OcclusionCuller::BeginDepthPass(const glm::mat4& proj_view_mat, int width, int height) {
+	proj_view_mat_ = proj_view_mat;
+	Resize(width, height);
+
+	// Fresh slots don't read the visibility buffer, so it needs no clearing when it grows
+	Reserve(&chunk_buffer_, &chunk_capacity_, chunks_.size() * sizeof(GpuChunk), false);
+	Reserve(&visibility_buffer_, &visibility_capacity_, num_slots_ * sizeof(GLuint), true);
+	Reserve(&command_buffer_, &command_capacity_, chunks_.size() * block::kNumRenderTypes * kCommandSize, false);
+	if (!chunks_.empty()) {
+		glNamedBufferSubData(chunk_buffer_, 0, chunks_.size() * sizeof(GpuChunk), chunks_.data());
+	}
+
+	// Phase 0, the opaque commands of chunks that were visible last frame
+	DispatchCull(0);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+	// Headless runs draw into an offscreen framebuffer, which is bound again in Cull
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer_);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, depth_framebuffer_);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer_);
+	depth_shader_->Use();
+	depth_shader_->SetMatrix4("uPVMMat", proj_view_mat);
+}
+
+void OcclusionCuller::Cull() {
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previous_framebuffer_);
+
+	// Pyramid, every level halves the previous one keeping the farthest depth
+	hiz_copy_shader_->Use();
+	hiz_copy_shader_->SetInt("uDepth", 0);
+	glBindTextureUnit(0, depth_texture_);
+	glBindImageTexture(0, hiz_texture_, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+	glDispatchCompute(GetNumGroups(width_, 8), GetNumGroups(height_, 8), 1);
+
+	hiz_reduce_shader_->Use();
+	for (int level = 1; level < num_levels_; ++level) {
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		glBindImageTexture(0, hiz_texture_, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+		glBindImageTexture(1, hiz_texture_, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		glDispatchCompute(GetNumGroups(std::max(width_ >> level, 1), 8), GetNumGroups(std::max(height_ >> level, 1), 8), 1);
+	}
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+	// Phase 1, every chunk against the pyramid
+	glClearNamedBufferData(counter_buffer_, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+	glBindTextureUnit(0, hiz_texture_);
+	DispatchCull(1);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	ReadVisibleChunks();
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer_);
+}
+
+size_t OcclusionCuller::GetCommandOffset(int chunk, block::RenderType type) {
+	return ((size_t)chunk * block::kNumRenderTypes + type) * kCommandSize;
+}
+
+int OcclusionCuller::GetNumChunks() const {
+	return (int)chunks_.size();
+}
+
+int OcclusionCuller::GetVisibleChunks() const {
+	return visible_chunks_;
+}
+
+void OcclusionCuller::Resize(int width, int height) {
+	width = std::max(width, 1);
+	height = std::max(height, 1);
+	if (width == width_ && height == height_) {
+		return;
+	}
+	width_ = width;
+	height_ = height;
+	num_levels_ = 1;
+	while ((std::max(width, height) >> num_levels_) > 0) {
+		++num_levels_;
+	}
+
+	glDeleteFramebuffers(1, &depth_framebuffer_);
+	glDeleteTextures(1, &depth_texture_);
+	glDeleteTextures(1, &hiz_texture_);
+
+	// Its own single sampled target, the window's depth buffer is multisampled and its format is up to the platform
+	glCreateTextures(GL_TEXTURE_2D, 1, &depth_texture_);
+	glTextureStorage2D(depth_texture_, 1, GL_DEPTH_COMPONENT32F, width, height);
+	glTextureParameteri(depth_texture_, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(depth_texture_, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &hiz_texture_);
+	glTextureStorage2D(hiz_texture_, num_levels_, GL_R32F, width, height);
+	glTextureParameteri(hiz_texture_, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTextureParameteri(hiz_texture_, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glCreateFramebuffers(1, &depth_framebuffer_);
+	glNamedFramebufferTexture(depth_framebuffer_, GL_DEPTH_ATTACHMENT, depth_texture_, 0);
+	glNamedFramebufferDrawBuffer(depth_framebuffer_, GL_NONE);
+	glNamedFramebufferReadBuffer(depth_framebuffer_, GL_NONE);
+	if (glCheckNamedFramebufferStatus(depth_framebuffer_, GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cerr << "[ERROR] Occlusion culling depth target is incomplete" << std::endl;
+	}
+}
+
+void OcclusionCuller::DispatchCull(int phase) {
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, chunk_buffer_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, visibility_buffer_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, command_buffer_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, counter_buffer_);
+
+	cull_shader_->Use();
+	cull_shader_->SetMatrix4("uProjViewMat", proj_view_mat_);
+	cull_shader_->SetInt("uNumChunks", (int)chunks_.size());
+	cull_shader_->SetInt("uPhase", phase);
+	cull_shader_->SetInt("uHiZ", 0);
+	cull_shader_->SetInt("uNumLevels", num_levels_);
+	glDispatchCompute(GetNumGroups((int)chunks_.size(), 64), 1, 1);
+}
+
+void OcclusionCuller::ReadVisibleChunks() {
+	// The count is copied into one of a few buffers and read once its fence has passed, instead of waiting for the GPU
+	const int frame = (int)(num_frames_++ % kLatency);
+	if (fences_[frame]) {
+		GLint status = GL_UNSIGNALED;
+		glGetSynciv(fences_[frame], GL_SYNC_STATUS, 1, nullptr, &status);
+		if (status == GL_SIGNALED) {
+			GLuint visible = 0;
+			glGetNamedBufferSubData(readback_buffers_[frame], 0, sizeof(GLuint), &visible);
+			visible_chunks_ = (int)visible;
+		}
+		glDeleteSync(fences_[frame]);
+	}
+	glCopyNamedBufferSubData(counter_buffer_, readback_buffers_[frame], 0, 0, sizeof(GLuint));
+	fences_[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
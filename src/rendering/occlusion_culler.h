@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <src/world/block.h>
+
+class Shader;
+
+// Two phase GPU occlusion culling of chunks against a hierarchical depth (Hi-Z) pyramid
+// The opaque faces of chunks that were visible last frame are drawn into a depth prepass, every chunk's box is then tested
+// against the farthest depth under it, and a compute shader writes the indirect draw commands of the main passes
+// Nothing is read back on the critical path, only the visible count for the debug text, a few frames late
+class OcclusionCuller {
+public:
+	OcclusionCuller();
+	~OcclusionCuller();
+
+	// Remembers whether a chunk was visible between frames, slots are reused once freed
+	int AllocateSlot();
+	void FreeSlot(int slot);
+
+	// Chunks are culled in the order they are added, which is the order of their commands
+	void ClearChunks();
+	void AddChunk(int slot, const glm::vec3& min, const glm::vec3& max, const std::array<uint32_t, block::kNumRenderTypes + 1>& index_offsets);
+
+	// Binds the depth target and the commands, draw every chunk's opaque command until Cull
+	void BeginDepthPass(const glm::mat4& proj_view_mat, int width, int height);
+	// Builds the pyramid from the prepass and writes the commands of every render type, which stay bound for the main passes
+	void Cull();
+
+	// Byte offset of a chunk's command in the bound GL_DRAW_INDIRECT_BUFFER
+	static size_t GetCommandOffset(int chunk, block::RenderType type);
+	int GetNumChunks() const;
+	int GetVisibleChunks() const; // Of a frame a few frames ago
+
+private:
+	// Same layout as Chunk in cull.comp (std430)
+	struct GpuChunk {
+		glm::vec4 min;
+		glm::vec4 max;
+		uint32_t first[block::kNumRenderTypes];
+		uint32_t count[block::kNumRenderTypes];
+		uint32_t slot;
+		uint32_t fresh; // First frame of the slot, without an earlier visibility
+	};
+	static_assert(sizeof(GpuChunk) == 64, "GpuChunk must match the std430 layout of cull.comp");
+
+	void Resize(int width, int height);
+	void DispatchCull(int phase);
+	void ReadVisibleChunks();
+
+private:
+	static inline constexpr int kLatency = 3; // Frames in flight
+	static inline constexpr size_t kCommandSize = 5 * sizeof(GLuint); // DrawElementsIndirectCommand
+
+	std::unique_ptr<Shader> depth_shader_;
+	std::unique_ptr<Shader> hiz_copy_shader_;
+	std::unique_ptr<Shader> hiz_reduce_shader_;
+	std::unique_ptr<Shader> cull_shader_;
+
+	std::vector<GpuChunk> chunks_;
+	std::vector<uint8_t> fresh_; // Per slot
+	std::vector<int> free_slots_;
+	int num_slots_ = 0;
+	glm::mat4 proj_view_mat_ = glm::mat4(1.0f);
+
+	// Buffers grow geometrically like ShapeBatch, capacities are in bytes
+	GLuint chunk_buffer_ = 0;
+	GLuint visibility_buffer_ = 0;
+	GLuint command_buffer_ = 0;
+	GLuint counter_buffer_ = 0;
+	size_t chunk_capacity_ = 0;
+	size_t visibility_capacity_ = 0;
+	size_t command_capacity_ = 0;
+
+	// Depth prepass target and the pyramid, level 0 is the size of the viewport
+	int width_ = 0;
+	int height_ = 0;
+	int num_levels_ = 0;
+	GLuint depth_texture_ = 0;
+	GLuint depth_framebuffer_ = 0;
+	GLuint hiz_texture_ = 0;
+	GLint previous_framebuffer_ = 0;
+
+	GLuint readback_buffers_[kLatency] = {};
+	GLsync fences_[kLatency] = {};
+	uint64_t num_frames_ = 0;
+	int visible_chunks_ = 0;
+
+};
@@ -0,0 +1,74 @@
+#include "shape_batch.h"
+
+#include <algorithm>
+#include <src/gl/shader.h>
+
+ShapeBatch::ShapeBatch() {
+	glGenVertexArrays(1, &vao_);
+	glGenBuffers(1, &vbo_);
+
+	glBindVertexArray(vao_);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(2 * sizeof(GLfloat)));
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+ShapeBatch::~ShapeBatch() {
+	glDeleteBuffers(1, &vbo_);
+	glDeleteVertexArrays(1, &vao_);
+}
+
+void ShapeBatch::AddQuad(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color) {
+	AddVertex({ min.x, max.y }, color);
+	AddVertex({ min.x, min.y }, color);
+	AddVertex({ max.x, min.y }, color);
+	AddVertex({ min.x, max.y }, color);
+	AddVertex({ max.x, min.y }, color);
+	AddVertex({ max.x, max.y }, color);
+}
+
+void ShapeBatch::AddLine(const glm::vec2& a, const glm::vec2& b, float width, const glm::vec4& color) {
+	glm::vec2 dir = b - a;
+	float length = glm::length(dir);
+	if (length == 0.0f) {
+		return;
+	}
+	// Extrude the line sideways into a quad
+	glm::vec2 offset = glm::vec2(-dir.y, dir.x) * (0.5f * width / length);
+	AddVertex(a + offset, color);
+	AddVertex(a - offset, color);
+	AddVertex(b - offset, color);
+	AddVertex(a + offset, color);
+	AddVertex(b - offset, color);
+	AddVertex(b + offset, color);
+}
+
+void ShapeBatch::Render(const std::unique_ptr<Shader>& shader) {
+	if (vertices_.empty()) {
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+	if (vertices_.size() > capacity_) {
+		// Grow geometrically, so the buffer is reallocated only a few times
+		capacity_ = std::max(2 * capacity_, vertices_.size());
+		glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(GLfloat), nullptr, GL_STREAM_DRAW);
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_.size() * sizeof(GLfloat), vertices_.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	shader->Use();
+	glBindVertexArray(vao_);
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(vertices_.size() / 6));
+
+	vertices_.clear();
+}
+
+void ShapeBatch::AddVertex(const glm::vec2& pos, const glm::vec4& color) {
+	vertices_.insert(vertices_.end(), { pos.x, pos.y, color.x, color.y, color.z, color.w });
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+class Shader;
+
+// Flat colored 2D quads and lines, collected over a frame and drawn with a single draw call
+class ShapeBatch {
+public:
+	ShapeBatch();
+	~ShapeBatch();
+
+	void AddQuad(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color);
+	void AddLine(const glm::vec2& a, const glm::vec2& b, float width, const glm::vec4& color);
+
+	// Draws and clears all shapes added since the last call
+	void Render(const std::unique_ptr<Shader>& shader);
+
+private:
+	void AddVertex(const glm::vec2& pos, const glm::vec4& color);
+
+private:
+	std::vector<float> vertices_; // [x, y, r, g, b, a]
+
+	GLuint vao_;
+	GLuint vbo_;
+	size_t capacity_ = 0; // Size of the vertex buffer in floats
+
+};
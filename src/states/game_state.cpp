@@ -2,136 +2,689 @@
 
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <chrono>
 #include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <src/gl/shader.h>
 #include <src/gl/texture.h>
+#include <src/gl/mesh.h>
+#include <src/gl/gpu_timer.h>
+#include <src/gl/fragment_counter.h>
 #include <src/rendering/camera.h>
+#include <src/rendering/shape_batch.h>
+#include <src/rendering/occlusion_culler.h>
 #include <src/text/font.h>
 #include <src/text/text.h>
 #include <src/utils/math.h>
+#include <src/utils/fixed_timestep.h>
+#include <src/utils/radix_sort.h>
+#include <src/utils/image.h>
+#include <src/utils/thread_pool.h>
+#include <src/utils/task_graph.h>
 
 #include <src/utils/debug.h>
+#include <src/utils/profiler.h>
+#include <src/physics/physics.h>
 #include <src/world/chunk_manager.h>
 #include <src/world/chunk.h>
+#include <src/world/lighting.h>
+#include <src/world/lod.h>
+#include <src/world/mesher.h>
+#include <src/bench/edit_benchmark.h>
+#include <src/bench/raycast_benchmark.h>
+#include <src/bench/collision_benchmark.h>
+#include <src/bench/flythrough_benchmark.h>
 
 GameState::GameState(Window* window) : State(window) {
+	startup_start_ = std::chrono::steady_clock::now();
 	window_->SetCursorMode(Window::CursorMode::kDisabled);
 	window_->SetCursorPos(0.0, 0.0); // Center cursor for camera movement
 
-	shader_ = std::make_unique<Shader>("data/shaders/basic.vert", "data/shaders/basic.frag");
-	texture_ = std::make_unique<Texture>("data/textures/face.png", TextureParams(GL_REPEAT, GL_REPEAT, GL_NEAREST_MIPMAP_LINEAR, GL_NEAREST, true, 16.0f));
-
 	camera_ = std::make_unique<Camera>();
 	camera_->SetAspectRatio((float)window->GetWidth() / (float)window->GetHeight());
-	camera_->SetPosition(glm::vec3(0.0f, 1.8f, 0.0f));
-
-	chunk_manager_ = std::make_unique<ChunkManager>();
+	camera_->SetPosition(player_.position + glm::vec3(0.0f, eye_height_, 0.0f));
+	prev_player_position_ = player_.position;
+
+	// Loads that don't touch OpenGL run on workers while this thread, which owns the context, compiles shaders
+	// Mipmaps stop at one texel per 16x16 tile, coarser levels would mix neighbouring tiles
+	const char* texture_path = "data/textures/terrain.png";
+	TextureParams texture_params(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_NEAREST_MIPMAP_LINEAR, GL_NEAREST, true, 16.0f, 4);
+	std::unique_ptr<image::Image> texture_image;
+	loader_ = std::make_unique<ThreadPool>(ThreadPool::GetDefaultNumThreads());
+
+	TaskGraph startup;
+	const int terrain_image = startup.Add("terrain_image", TaskGraph::Thread::kWorker, [&]() {
+		texture_image = image::Load(texture_path, texture_params.max_level_ + 1);
+	});
+	startup.Add("terrain_texture", TaskGraph::Thread::kMain, [&]() {
+		if (texture_image) {
+			texture_ = std::make_unique<Texture>(*texture_image, texture_params);
+		} else {
+			texture_ = std::make_unique<Texture>(texture_path, texture_params); // Placeholder texture
+		}
+	}, { terrain_image });
+	startup.Add("world", TaskGraph::Thread::kWorker, [this]() {
+		chunk_manager_ = std::make_unique<ChunkManager>();
+		lod_manager_ = std::make_unique<LodManager>();
+		physics_ = std::make_unique<Physics>(chunk_manager_.get());
+	});
+	startup.Add("chunk_shaders", TaskGraph::Thread::kMain, [this]() {
+		shader_ = std::make_unique<Shader>("data/shaders/basic.vert", "data/shaders/basic.frag");
+		cutout_shader_ = std::make_unique<Shader>("data/shaders/basic.vert", "data/shaders/cutout.frag");
+		lod_shader_ = std::make_unique<Shader>("data/shaders/basic.vert", "data/shaders/lod.frag");
+	});
+	startup.Add("occlusion_culler", TaskGraph::Thread::kMain, [this]() {
+		occlusion_culler_ = std::make_unique<OcclusionCuller>();
+	});
+	startup.Add("ui_shaders", TaskGraph::Thread::kMain, [this]() {
+		text_shader_ = std::make_unique<Shader>("data/shaders/text.vert", "data/shaders/text_sdf.frag");
+		shape_shader_ = std::make_unique<Shader>("data/shaders/shape.vert", "data/shaders/shape.frag");
+		shape_batch_ = std::make_unique<ShapeBatch>();
+	});
+	startup.Run(*loader_);
+	startup.LogTimings("Startup");
+
+	// The font takes seconds and the first frames can do without text, so its atlas is generated in the background
+	// and uploaded by the render thread once ready (see LoadFont)
+	// Started last, the loads above would otherwise queue behind its glyphs on the pool
+	font_atlas_ = std::async(std::launch::async, [pool = loader_.get()]() {
+		return std::make_unique<FontAtlas>(Font::GenerateSdfAtlas("data/fonts/Roboto-Regular.ttf", 1024, 1024, 8, pool));
+	});
+
+	gpu_timer_ = std::unique_ptr<GpuTimer>(new GpuTimer({ "Chunks", "UI", "Upload", "LOD", "Translucent", "Culling" })); // Indexed by kChunkPass, kUIPass, kUploadPass, kLodPass, kTranslucentPass, kCullPass
+	fragment_counter_ = std::make_unique<FragmentCounter>(gpu_timer_->GetNumPasses());
+}
 
-	// Text
-	text_shader_ = std::make_unique<Shader>("data/shaders/text.vert", "data/shaders/text_sdf.frag");
-	font_ = std::make_unique<Font>("data/fonts/Roboto-Regular.ttf", 1024, 1024, 8);
-	font_->GetAtlas()->SavePNG("atlas.png");
-	fps_text_ = std::make_unique<Text>("0 FPS", 24, font_.get());
-	debug_text_ = std::make_unique<Text>("", 24, font_.get());
+GameState::~GameState() {
 
-	glm::vec4 shadow_color(glm::vec3(0.0f), 0.5f);
-	fps_text_->SetShadow(1, shadow_color);
-	debug_text_->SetShadow(1, shadow_color);
 }
 
-GameState::~GameState() {
+void GameState::Tick(float dt) {
+	PROFILE_SCOPE("GameState::Tick");
+	const auto time_start = std::chrono::steady_clock::now();
 
+	// Player, placed by the flythrough benchmark while it runs
+	if (flythrough_) {
+		prev_player_position_ = player_.position;
+	} else {
+		MovePlayer(dt);
+	}
+
+	// World
+	glm::vec3 eye_pos = player_.position + glm::vec3(0.0f, eye_height_, 0.0f);
+	if (edit_benchmark_) {
+		edit_benchmark_->Update(dt, eye_pos);
+	}
+	chunk_manager_->Update(eye_pos);
+	lod_manager_->Update(eye_pos, chunk_manager_->GetLoadRegion(), chunk_manager_->GetCenter());
+
+	++tick_count_;
+	tick_ms_ += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - time_start).count();
 }
 
-void GameState::Update(float dt) {
+void GameState::MovePlayer(float dt) {
 	// Input
+	glm::vec3 norm_input(0.0f);
 	if (input_ != glm::ivec3(0)) {
-		glm::vec3 norm_input = glm::normalize(glm::vec3(input_));
-
-		glm::vec3 pos = camera_->GetPosition();
-		glm::vec3 rot = camera_->GetRotation();
-
+		norm_input = glm::normalize(glm::vec3(input_));
+	}
+	glm::vec3 up(0.0f, 1.0f, 0.0f);
+	if (flying_) {
 		glm::vec3 forward = camera_->GetForward();
-		glm::vec3 up(0.0f, 1.0f, 0.0f);
 		glm::vec3 right = glm::cross(forward, up);
 
 		float speed = sprinting_ ? 20.0f : 5.0f;
-		pos += speed * dt * (norm_input.x * right + norm_input.y * up + norm_input.z * -forward);
-		camera_->SetPosition(pos);
+		player_.velocity = speed * (norm_input.x * right + norm_input.y * up + norm_input.z * -forward);
+	} else {
+		// Walk in the horizontal plane regardless of pitch
+		float yaw = camera_->GetRotation().y;
+		glm::vec3 forward(-std::sin(yaw), 0.0f, -std::cos(yaw));
+		glm::vec3 right = glm::cross(forward, up);
+
+		float speed = sprinting_ ? 5.6f : 4.3f;
+		glm::vec3 walk_input = input_.x != 0 || input_.z != 0 ? glm::normalize(glm::vec3(input_.x, 0, input_.z)) : glm::vec3(0.0f);
+		glm::vec3 velocity = speed * (walk_input.x * right + walk_input.z * -forward);
+		player_.velocity.x = velocity.x;
+		player_.velocity.z = velocity.z;
+		if (input_.y > 0 && player_.on_ground) {
+			player_.velocity.y = jump_speed_;
+		}
 	}
+	player_.gravity = !flying_;
+
+	// Physics
+	prev_player_position_ = player_.position;
+	physics_->Step(player_, dt);
+}
+
+void GameState::Update(float dt, const FixedTimestep& timestep) {
+	PROFILE_SCOPE("GameState::Update");
+	const auto time_start = std::chrono::steady_clock::now();
+
+	if (quit_after_flythrough_ && flythrough_done_) {
+		window_->Close();
+	}
+
+	// TPS
+	tps_time_ += dt;
+	if (tps_time_ >= 1.0f) {
+		tps_ = (int)std::round((float)tick_count_ / tps_time_);
+		tick_count_ = 0;
+		tps_time_ = 0.0f;
+	}
+
+	// Don't overwrite a frame the render thread hasn't picked up yet, keep simulating instead.
+	// Checked only once, the render thread can pick the frame up at any point during the update
+	if (!frames_.IsConsumed()) {
+		return;
+	}
+
+	// Advance the flythrough once per published frame, so every run renders the same poses
+	if (flythrough_) {
+		FlythroughBenchmark::Pose pose = flythrough_->GetPose(flythrough_frame_);
+		player_.position = pose.position - glm::vec3(0.0f, eye_height_, 0.0f);
+		player_.velocity = glm::vec3(0.0f);
+		prev_player_position_ = player_.position;
+		camera_->SetRotation(pose.rotation);
+	}
+
+	// Interpolate between the last two ticks, so movement is smooth at any frame rate
+	glm::vec3 player_pos = glm::mix(prev_player_position_, player_.position, timestep.GetAlpha());
+	camera_->SetPosition(player_pos + glm::vec3(0.0f, eye_height_, 0.0f));
 
 	// 3D
 	camera_->Update();
-	chunk_manager_->Update(camera_->GetPosition());
-
-	// FPS
-	++fps_count_;
-	fps_time_ += dt;
-	if (fps_time_ >= 1.0f) {
-		fps_ = (int)std::round((float)fps_count_ / fps_time_);
-		fps_text_->SetText(std::to_string(fps_) + " FPS");
-		fps_count_ = 0;
-		fps_time_ = 0.0f;
+	has_target_ = raycast::CastRay(*chunk_manager_, camera_->GetPosition(), camera_->GetForward(), reach_, &target_);
+
+	Frame& frame = frames_.GetWriteBuffer();
+	frame.width = window_->GetWidth();
+	frame.height = window_->GetHeight();
+	frame.proj_view_mat = camera_->GetProjViewMat();
+
+	AddChunkDraws(frame);
+
+	frame.lod_levels.resize(LodManager::kNumLevels);
+	for (int level = 1; level <= LodManager::kNumLevels; ++level) {
+		Frame::LodLevel& lod_level = frame.lod_levels[level - 1];
+		lod_level.clip_region = lod_manager_->GetRegion(level - 1);
+		lod_level.clip_center = lod_manager_->GetCenter(level - 1);
+		lod_level.clip_cell_size = LodManager::GetTileSize(level - 1);
+		lod_level.tiles.clear();
+		for (const auto& [index, mesh] : lod_manager_->GetTiles(level)) {
+			if (lod_manager_->IsInRegion(level, index) && !mesh->indices.empty()) {
+				lod_level.tiles.push_back({ index, mesh, nullptr });
+			}
+		}
+		SortNearestFirst(lod_level.tiles, (float)LodManager::GetTileSize(level));
 	}
+	frame.farthest_first = farthest_first_;
+	frame.occlusion_culling = occlusion_culling_;
 
 	// Debugging
+	frame.show_debug_info = show_debug_info_;
 	if (show_debug_info_) {
 		glm::vec3 pos = camera_->GetPosition();
 		glm::ivec3 chunk_pos(glm::floor(pos / (float)Chunk::kSize));
 		glm::vec3 dir = camera_->GetForward();
-		debug_text_->SetText(
+		ChunkManager::Backlog backlog = chunk_manager_->GetBacklog();
+		uint8_t packed_light = chunk_manager_->GetLight(glm::ivec3(glm::floor(pos)));
+		frame.debug_text = (
 			debug::FormatString("XYZ: %.4f / %.4f / %.4f\n", pos.x, pos.y, pos.z) +
 			debug::FormatString("Chunk: %d, %d, %d\n", chunk_pos.x, chunk_pos.y, chunk_pos.z) +
-			debug::FormatString("Direction: %.2f, %.2f, %.2f", dir.x, dir.y, dir.z)
+			debug::FormatString("Direction: %.2f, %.2f, %.2f\n", dir.x, dir.y, dir.z) +
+			(has_target_ ? debug::FormatString("Target: %d, %d, %d\n", target_.block.x, target_.block.y, target_.block.z) : "Target: none\n") +
+			debug::FormatString("Block: %s\n", block::GetInfo(place_block_).name) +
+			debug::FormatString("Light: sky %d, block %d\n", light::GetSky(packed_light), light::GetBlock(packed_light)) +
+			debug::FormatString("Chunks: %d (load %d, unload %d, mesh %d)\n", (int)chunk_manager_->GetChunks().size(), backlog.loads, backlog.unloads, backlog.remeshes) +
+			debug::FormatString("LOD: %d / %d / %d tiles (mesh %d)\n", (int)lod_manager_->GetTiles(1).size(), (int)lod_manager_->GetTiles(2).size(), (int)lod_manager_->GetTiles(3).size(), lod_manager_->GetBacklog()) +
+			debug::FormatString("Ticks: %d/s, %d this frame (backlog %.2f ms, dropped %d)\n", tps_, timestep.GetTicks(), 1000.0f * timestep.GetBacklog(), timestep.GetDroppedTicks())
 		);
 	}
+
+	const ChunkManager::Counters& counters = chunk_manager_->GetCounters();
+	frame.chunk_loads = (int)(counters.loads - published_loads_);
+	frame.chunk_meshes = (int)(counters.meshes - published_meshes_);
+	published_loads_ = counters.loads;
+	published_meshes_ = counters.meshes;
+
+	frame.flythrough = flythrough_;
+	frame.flythrough_frame = flythrough_ ? flythrough_frame_ : -1;
+	if (flythrough_ && ++flythrough_frame_ == flythrough_->GetNumFrames()) {
+		flythrough_ = nullptr; // The render thread writes the report after drawing the last frame
+	}
+
+	frame.sim_ms = tick_ms_ + std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - time_start).count();
+	tick_ms_ = 0.0f;
+	frames_.Publish();
+}
+
+bool GameState::IsFramePending() const {
+	return !frames_.IsConsumed();
 }
 
-void GameState::Render() {
+void GameState::AddChunkDraws(Frame& frame) {
+	PROFILE_SCOPE("GameState::AddChunkDraws");
+	++published_frames_;
+	const glm::vec3 eye = camera_->GetPosition();
+	const glm::ivec3 eye_block(glm::floor(eye));
+
+	// Chunks kept loaded past the load region are left to the first level of detail, which draws that area
+	frame.chunks.clear();
+	for (const auto& [index, chunk] : chunk_manager_->GetChunks()) {
+		if (!chunk_manager_->IsInLoadRegion(index) || !chunk->mesh_ || chunk->mesh_->indices.empty()) {
+			continue;
+		}
+		Frame::ChunkDraw& draw = frame.chunks.emplace_back(Frame::ChunkDraw{ index, chunk->mesh_, nullptr });
+		if (chunk->mesh_->GetNumIndices(block::kTranslucent) == 0) {
+			continue;
+		}
+
+		// Faces only swap order when the eye crosses the plane of one of them, which lies on a block boundary
+		TranslucentSort& sort = translucent_sorts_[index];
+		if (sort.mesh_id != chunk->mesh_->id || sort.eye_block != eye_block || !sort.indices) {
+			auto indices = std::make_shared<std::vector<uint32_t>>();
+			mesher::SortTranslucent(*chunk->mesh_, eye, indices.get());
+			sort.mesh_id = chunk->mesh_->id;
+			sort.eye_block = eye_block;
+			sort.indices = std::move(indices);
+		}
+		sort.last_frame = published_frames_;
+		draw.translucent_indices = sort.indices;
+	}
+	for (auto it = translucent_sorts_.begin(); it != translucent_sorts_.end();) {
+		if (it->second.last_frame != published_frames_) {
+			it = translucent_sorts_.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// The translucent pass walks the same list backwards
+	SortNearestFirst(frame.chunks, (float)Chunk::kSize);
+}
+
+void GameState::SortNearestFirst(std::vector<Frame::ChunkDraw>& draws, float cell_size) {
+	// Nearer geometry fills the depth buffer first, so fragments behind it fail the early depth test instead of being shaded
+	// Keys are the distance to the cell center in quarter blocks, with the draw's position in the low 16 bits
+	constexpr size_t kMaxDraws = 1 << 16;
+	const glm::vec3 eye = camera_->GetPosition();
+	auto distance = [&](const Frame::ChunkDraw& draw) {
+		return glm::length((glm::vec3(draw.index) + 0.5f) * cell_size - eye);
+	};
+	if (draws.size() > kMaxDraws) {
+		std::sort(draws.begin(), draws.end(), [&](const Frame::ChunkDraw& a, const Frame::ChunkDraw& b) {
+			return distance(a) < distance(b);
+		});
+		return;
+	}
+
+	sort_keys_.resize(draws.size());
+	sort_scratch_.resize(draws.size());
+	for (size_t i = 0; i < draws.size(); ++i) {
+		const uint32_t quantized = (uint32_t)std::min(4.0f * distance(draws[i]), 65535.0f);
+		sort_keys_[i] = (quantized << 16) | (uint32_t)i;
+	}
+	radix::Sort(sort_keys_.data(), sort_scratch_.data(), sort_keys_.size(), 2);
+
+	sorted_draws_.clear();
+	for (uint32_t key : sort_keys_) {
+		sorted_draws_.push_back(std::move(draws[key & 0xFFFF]));
+	}
+	draws.swap(sorted_draws_);
+}
+
+bool GameState::Render() {
+	if (!frames_.Update()) {
+		return false;
+	}
+	PROFILE_SCOPE("GameState::Render");
+	const Frame& frame = frames_.GetReadBuffer();
+	const auto time_start = std::chrono::steady_clock::now();
+
+	if (frame.width != viewport_width_ || frame.height != viewport_height_) {
+		glViewport(0, 0, frame.width, frame.height);
+		viewport_width_ = frame.width;
+		viewport_height_ = frame.height;
+	}
+
+	// Blending is only enabled for the translucent pass and the UI
 	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_BLEND);
+	glDisable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	gpu_timer_->BeginFrame();
+	fragment_counter_->BeginFrame();
+
 	glClearColor(0.5f, 0.675f, 0.85f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 
+	// Upload
+	++render_frame_;
+	gpu_timer_->Begin(kUploadPass);
+	UploadChunkMeshes(frame);
+	gpu_timer_->End(kUploadPass);
+
+	glm::mat4 model_mat(1.0f);
+	model_mat = glm::translate(model_mat, glm::vec3(0.0f, 0.0f, 0.0f));
+	glm::mat4 pvm_mat = frame.proj_view_mat * model_mat;
+	int draw_calls = 0;
+
+	// Depth of the chunks visible last frame, then every chunk is tested against it on the GPU
+	const bool culled = frame.occlusion_culling;
+	if (culled) {
+		gpu_timer_->Begin(kCullPass);
+		occlusion_culler_->BeginDepthPass(pvm_mat, frame.width, frame.height);
+		DrawChunks(block::kOpaque, false, true, &draw_calls); // Commands of chunks that weren't visible have no instances yet
+		occlusion_culler_->Cull();
+		gpu_timer_->End(kCullPass);
+	}
+
 	// 3D
+	gpu_timer_->Begin(kChunkPass);
 	shader_->Use();
 	glActiveTexture(GL_TEXTURE0);
 	texture_->Bind();
-
-	glm::mat4 model_mat(1.0f);
-	model_mat = glm::translate(model_mat, glm::vec3(0.0f, 0.0f, 0.0f));
-	glm::mat4 pvm_mat = camera_->GetProjViewMat() * model_mat;
 	shader_->SetMatrix4("uPVMMat", pvm_mat);
 
-	for (const auto& [_, chunk] : chunk_manager_->GetChunks()) {
-		glBindVertexArray(chunk->vao_);
-		glDrawElements(GL_TRIANGLES, chunk->num_indices_, GL_UNSIGNED_INT, 0);
+	fragment_counter_->Begin(kChunkPass);
+	DrawChunks(block::kOpaque, frame.farthest_first, culled, &draw_calls);
+	cutout_shader_->Use();
+	cutout_shader_->SetMatrix4("uPVMMat", pvm_mat);
+	DrawChunks(block::kCutout, frame.farthest_first, culled, &draw_calls);
+	fragment_counter_->End(kChunkPass);
+	gpu_timer_->End(kChunkPass);
+
+	// Distant terrain, each level cut out where the finer one is drawn
+	gpu_timer_->Begin(kLodPass);
+	fragment_counter_->Begin(kLodPass);
+	lod_shader_->Use();
+	lod_shader_->SetMatrix4("uPVMMat", pvm_mat);
+	for (size_t level = 0; level < frame.lod_levels.size(); ++level) {
+		const Frame::LodLevel& lod_level = frame.lod_levels[level];
+		lod_shader_->SetInt("uClipShape", lod_level.clip_region.shape);
+		lod_shader_->SetFloat("uClipRadius", (float)lod_level.clip_region.radius);
+		lod_shader_->SetFloat("uClipHeight", (float)lod_level.clip_region.height);
+		lod_shader_->SetVector3("uClipCenter", glm::vec3(lod_level.clip_center));
+		lod_shader_->SetFloat("uClipCellSize", (float)lod_level.clip_cell_size);
+		const std::vector<const Mesh*>& draw_list = lod_buffers_[level].draw_list;
+		for (size_t i = 0; i < draw_list.size(); ++i) {
+			draw_list[frame.farthest_first ? draw_list.size() - 1 - i : i]->Draw();
+			++draw_calls;
+		}
+	}
+	fragment_counter_->End(kLodPass);
+	gpu_timer_->End(kLodPass);
+
+	// Translucent faces last, without depth writes so the ones behind them still blend in
+	gpu_timer_->Begin(kTranslucentPass);
+	fragment_counter_->Begin(kTranslucentPass);
+	glEnable(GL_BLEND);
+	glDepthMask(GL_FALSE);
+	shader_->Use();
+	DrawChunks(block::kTranslucent, true, culled, &draw_calls);
+	glDepthMask(GL_TRUE);
+	fragment_counter_->End(kTranslucentPass);
+	gpu_timer_->End(kTranslucentPass);
+
+	// Free buffers of chunks and tiles that were unloaded or became empty
+	auto free_unused = [this](ChunkBufferMap& buffers) {
+		for (auto it = buffers.begin(); it != buffers.end();) {
+			if (it->second.last_frame != render_frame_) {
+				if (it->second.cull_slot >= 0) {
+					occlusion_culler_->FreeSlot(it->second.cull_slot);
+				}
+				it = buffers.erase(it);
+			} else {
+				++it;
+			}
+		}
+	};
+	free_unused(chunk_buffers_);
+	for (LodBuffers& lod_buffers : lod_buffers_) {
+		free_unused(lod_buffers.buffers);
 	}
 
 
 	// UI
+	gpu_timer_->Begin(kUIPass);
 	glDisable(GL_DEPTH_TEST);
-	text_shader_->Use();
-	glActiveTexture(GL_TEXTURE0);
+	glm::mat4 ui_proj_mat = glm::ortho(0.0f, (float)frame.width, 0.0f, (float)frame.height, -1.0f, 1.0f);
 
-	glm::mat4 ui_proj_mat = glm::ortho(0.0f, (float)window_->GetWidth(), 0.0f, (float)window_->GetHeight(), -1.0f, 1.0f);
-	text_shader_->SetMatrix4("uProjMat", ui_proj_mat);
+	// FPS
+	const auto time_now = std::chrono::steady_clock::now();
+	float frame_dt = std::chrono::duration<float>(time_now - last_render_time_).count();
+	last_render_time_ = time_now;
+	frame_stats_.Add(1000.0f * frame_dt);
+	++fps_count_;
+	fps_time_ += frame_dt;
+	if (fps_time_ >= 1.0f) {
+		fps_ = (int)std::round((float)fps_count_ / fps_time_);
+		if (fps_text_) {
+			fps_text_->SetText(std::to_string(fps_) + " FPS");
+		}
+		fps_count_ = 0;
+		fps_time_ = 0.0f;
+		frame_summary_ = frame_stats_.Compute();
+	}
 
-	fps_text_->SetPosition(glm::vec2(8.0f, window_->GetHeight() - fps_text_->GetSize() - 4.0f));
-	fps_text_->Render(text_shader_);
+	if (frame.show_debug_info) {
+		RenderFrameTimeGraph(ui_proj_mat);
+		++draw_calls;
+	}
 
-	if (show_debug_info_) {
-		debug_text_->SetPosition(glm::vec2(8.0f, window_->GetHeight() - 3 * fps_text_->GetSize() - 4.0f));
+	if (!font_ && font_atlas_.valid() && font_atlas_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		LoadFont();
+	}
+	if (font_) {
+		text_shader_->Use();
+		glActiveTexture(GL_TEXTURE0);
+		text_shader_->SetMatrix4("uProjMat", ui_proj_mat);
+
+		fps_text_->SetPosition(glm::vec2(8.0f, frame.height - fps_text_->GetSize() - 4.0f));
+		fps_text_->Render(text_shader_);
+		++draw_calls;
+	}
+
+	// Pipeline timings are smoothed, since single frames vary a lot
+	const float smoothing = 0.05f;
+	sim_ms_ += smoothing * (frame.sim_ms - sim_ms_);
+	frame_ms_ += smoothing * (1000.0f * frame_dt - frame_ms_);
+
+	if (frame.show_debug_info && font_) {
+		// Stages overlap if a frame takes less time than simulating and rendering it one after another
+		debug_text_->SetText(frame.debug_text +
+			debug::FormatString("Pipeline: sim %.2f ms, render %.2f ms, frame %.2f ms (%.2fx)\n", sim_ms_, render_ms_, frame_ms_, (sim_ms_ + render_ms_) / frame_ms_) +
+			debug::FormatString("GPU: upload %.2f ms, culling %.2f ms, chunks %.2f ms, LOD %.2f ms, translucent %.2f ms, UI %.2f ms (%llu untimed)\n", gpu_timer_->GetMilliseconds(kUploadPass), gpu_timer_->GetMilliseconds(kCullPass), gpu_timer_->GetMilliseconds(kChunkPass), gpu_timer_->GetMilliseconds(kLodPass), gpu_timer_->GetMilliseconds(kTranslucentPass), gpu_timer_->GetMilliseconds(kUIPass), (unsigned long long)gpu_timer_->GetDroppedFrames()) +
+			(frame.occlusion_culling ? debug::FormatString("Culling: %d / %d chunks visible\n", occlusion_culler_->GetVisibleChunks(), occlusion_culler_->GetNumChunks()) : "Culling: off\n") +
+			debug::FormatString("Fragments: chunks %.2fM, LOD %.2fM, translucent %.2fM (%s first)\n", fragment_counter_->GetInvocations(kChunkPass) * 1e-6f, fragment_counter_->GetInvocations(kLodPass) * 1e-6f, fragment_counter_->GetInvocations(kTranslucentPass) * 1e-6f, frame.farthest_first ? "farthest" : "nearest") +
+			debug::FormatString("Uploads: %d (%.1f KB), waiting %d\n", upload_stats_.uploads, upload_stats_.bytes / 1024.0f, upload_stats_.waiting) +
+			debug::FormatString("Frame time: mean %.2f, p50 %.2f, p95 %.2f, p99 %.2f, max %.2f ms\n", frame_summary_.mean_ms, frame_summary_.p50_ms, frame_summary_.p95_ms, frame_summary_.p99_ms, frame_summary_.max_ms) +
+			debug::FormatString("Hitches: %d over %.1f ms in the last %d frames", frame_summary_.hitches, frame_stats_.GetHitchThreshold(), frame_summary_.num_frames)
+		);
+		debug_text_->SetPosition(glm::vec2(8.0f, frame.height - 3 * fps_text_->GetSize() - 4.0f));
 		debug_text_->Render(text_shader_);
+		++draw_calls;
+	}
+	gpu_timer_->End(kUIPass);
+
+	float render_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - time_start).count();
+	render_ms_ += smoothing * (render_ms - render_ms_);
+
+	if (frame.flythrough) {
+		FlythroughBenchmark::Sample sample;
+		sample.frame_ms = 1000.0f * frame_dt;
+		sample.sim_ms = frame.sim_ms;
+		sample.render_ms = render_ms;
+		sample.gpu_ms = gpu_timer_->GetMilliseconds(kUploadPass) + gpu_timer_->GetMilliseconds(kCullPass) + gpu_timer_->GetMilliseconds(kChunkPass) + gpu_timer_->GetMilliseconds(kLodPass) + gpu_timer_->GetMilliseconds(kTranslucentPass) + gpu_timer_->GetMilliseconds(kUIPass);
+		sample.chunks = (int)frame.chunks.size();
+		sample.loads = frame.chunk_loads;
+		sample.meshes = frame.chunk_meshes;
+		sample.draw_calls = draw_calls;
+		sample.fragments = fragment_counter_->GetInvocations(kChunkPass) + fragment_counter_->GetInvocations(kLodPass) + fragment_counter_->GetInvocations(kTranslucentPass);
+		if (frame.flythrough->Record(frame.flythrough_frame, sample)) {
+			flythrough_done_ = true;
+		}
 	}
+
+	if (!first_frame_logged_) {
+		first_frame_logged_ = true;
+		std::cout << debug::FormatString("[Startup] first_frame_ms=%.2f\n", std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startup_start_).count()) << std::flush;
+	}
+	return true;
+}
+
+void GameState::StartFlythrough(int num_frames, unsigned int seed, bool quit_when_done) {
+	// Start from a freshly generated world, so runs don't depend on what was loaded or edited before
+	edit_benchmark_ = nullptr;
+	chunk_manager_ = std::make_unique<ChunkManager>();
+	lod_manager_ = std::make_unique<LodManager>();
+	physics_ = std::make_unique<Physics>(chunk_manager_.get());
+	published_loads_ = 0;
+	published_meshes_ = 0;
+
+	flying_ = true;
+	flythrough_ = std::make_shared<FlythroughBenchmark>(num_frames, seed);
+	flythrough_frame_ = 0;
+	quit_after_flythrough_ = quit_when_done;
+	flythrough_done_ = false;
+	std::cout << "[Flythrough benchmark] Started, frames=" << flythrough_->GetNumFrames() << ", seed=" << seed << std::endl;
+}
+
+void GameState::SetFarthestFirst(bool farthest_first) {
+	farthest_first_ = farthest_first;
+}
+
+void GameState::SetOcclusionCulling(bool occlusion_culling) {
+	occlusion_culling_ = occlusion_culling;
+}
+
+void GameState::UploadChunkMeshes(const Frame& frame) {
+	// Meshes are generated on the simulation thread, the render thread only copies them to the GPU
+	// Spreading uploads over frames keeps a burst of remeshes from turning into one long frame
+	upload_stats_ = {};
+	draw_list_.clear();
+	occlusion_culler_->ClearChunks();
+	for (const auto& chunk : frame.chunks) {
+		ChunkBuffer& buffer = chunk_buffers_[chunk.index];
+		if (!UploadChunkMesh(buffer, *chunk.mesh)) {
+			continue;
+		}
+		// The sorted order belongs to the frame's mesh, a buffer still waiting for it keeps its previous order
+		if (buffer.mesh_id == chunk.mesh->id && buffer.translucent_indices != chunk.translucent_indices && chunk.translucent_indices) {
+			buffer.mesh->UploadIndices((int)buffer.index_offsets[block::kTranslucent], *chunk.translucent_indices);
+			buffer.translucent_indices = chunk.translucent_indices;
+			upload_stats_.bytes += (int)(chunk.translucent_indices->size() * sizeof(uint32_t));
+		}
+		if (buffer.cull_slot < 0) {
+			buffer.cull_slot = occlusion_culler_->AllocateSlot();
+		}
+		const glm::vec3 min(chunk.index * Chunk::kSize);
+		occlusion_culler_->AddChunk(buffer.cull_slot, min, min + (float)Chunk::kSize, buffer.index_offsets);
+		draw_list_.push_back(&buffer);
+	}
+
+	// Distant tiles come last, so nearby changes get the upload budget first
+	lod_buffers_.resize(frame.lod_levels.size());
+	for (size_t level = 0; level < frame.lod_levels.size(); ++level) {
+		LodBuffers& lod_buffers = lod_buffers_[level];
+		lod_buffers.draw_list.clear();
+		for (const auto& tile : frame.lod_levels[level].tiles) {
+			ChunkBuffer& buffer = lod_buffers.buffers[tile.index];
+			if (UploadChunkMesh(buffer, *tile.mesh)) {
+				lod_buffers.draw_list.push_back(buffer.mesh.get());
+			}
+		}
+	}
+}
+
+bool GameState::UploadChunkMesh(ChunkBuffer& buffer, const ChunkMesh& mesh) {
+	buffer.last_frame = render_frame_;
+	if (buffer.mesh_id != mesh.id) {
+		if (upload_stats_.uploads < max_uploads_per_frame_) {
+			if (!buffer.mesh) {
+				buffer.mesh = std::unique_ptr<Mesh>(new Mesh({ 3, 2, 1, 1, 1 })); // Position, texture coordinates, ambient occlusion, light, atlas tile
+			}
+			buffer.mesh->Upload(mesh.vertices, mesh.indices);
+			buffer.mesh_id = mesh.id;
+			buffer.index_offsets = mesh.index_offsets;
+			buffer.translucent_indices = nullptr;
+			++upload_stats_.uploads;
+			upload_stats_.bytes += (int)(mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(uint32_t));
+		} else {
+			++upload_stats_.waiting; // Keeps drawing its previous mesh, if any
+		}
+	}
+	return buffer.mesh_id != 0;
+}
+
+void GameState::DrawChunks(block::RenderType type, bool back_to_front, bool culled, int* draw_calls) const {
+	auto draw = [&](size_t i) {
+		const ChunkBuffer* buffer = draw_list_[i];
+		const int first = (int)buffer->index_offsets[type];
+		const int count = (int)buffer->index_offsets[type + 1] - first;
+		if (count == 0) {
+			return;
+		}
+		if (culled) {
+			buffer->mesh->DrawIndirect(OcclusionCuller::GetCommandOffset((int)i, type)); // Zero instances if culled
+		} else {
+			buffer->mesh->Draw(first, count);
+		}
+		++*draw_calls;
+	};
+	for (size_t i = 0; i < draw_list_.size(); ++i) {
+		draw(back_to_front ? draw_list_.size() - 1 - i : i);
+	}
+}
+
+void GameState::LoadFont() {
+	font_ = std::make_unique<Font>(std::move(*font_atlas_.get()));
+	font_->GetAtlas()->SavePNG("atlas.png");
+	fps_text_ = std::make_unique<Text>(std::to_string(fps_) + " FPS", 24, font_.get());
+	debug_text_ = std::make_unique<Text>("", 24, font_.get());
+
+	glm::vec4 shadow_color(glm::vec3(0.0f), 0.5f);
+	fps_text_->SetShadow(1, shadow_color);
+	debug_text_->SetShadow(1, shadow_color);
+	std::cout << debug::FormatString("[Startup] font_ms=%.2f\n", std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startup_start_).count()) << std::flush;
+}
+
+void GameState::RenderFrameTimeGraph(const glm::mat4& ui_proj_mat) {
+	// One bar per frame, newest on the right, in the bottom left corner
+	const glm::vec2 origin(8.0f, 8.0f);
+	const glm::vec2 size(360.0f, 90.0f);
+	const float bar_width = 1.5f;
+	const float hitch_ms = frame_stats_.GetHitchThreshold();
+	const float max_ms = 2.0f * hitch_ms;
+	const float target_ms = 1000.0f / 60.0f;
+
+	shape_batch_->AddQuad(origin, origin + size, glm::vec4(0.0f, 0.0f, 0.0f, 0.4f));
+
+	int num_bars = std::min(frame_stats_.GetNumSamples(), (int)(size.x / bar_width));
+	int first = frame_stats_.GetNumSamples() - num_bars;
+	for (int i = 0; i < num_bars; ++i) {
+		float ms = frame_stats_.GetSample(first + i);
+		glm::vec4 color = ms > hitch_ms ? glm::vec4(0.9f, 0.2f, 0.2f, 0.9f) : ms > target_ms ? glm::vec4(0.9f, 0.8f, 0.2f, 0.9f) : glm::vec4(0.3f, 0.85f, 0.3f, 0.9f);
+		float x = origin.x + size.x - (num_bars - i) * bar_width;
+		float height = std::min(ms / max_ms, 1.0f) * size.y;
+		shape_batch_->AddQuad({ x, origin.y }, { x + bar_width, origin.y + height }, color);
+	}
+
+	// Reference lines at 60 FPS and at the hitch threshold
+	for (float ms : { target_ms, hitch_ms }) {
+		float y = origin.y + ms / max_ms * size.y;
+		shape_batch_->AddLine({ origin.x, y }, { origin.x + size.x, y }, 1.0f, glm::vec4(1.0f, 1.0f, 1.0f, 0.5f));
+	}
+
+	shape_shader_->Use();
+	shape_shader_->SetMatrix4("uProjMat", ui_proj_mat);
+	shape_batch_->Render(shape_shader_);
 }
 
 void GameState::FramebufferSizeCallback(int width, int height) {
-	glViewport(0, 0, width, height);
+	// The viewport is updated by the render thread
 	camera_->SetAspectRatio((float)width / (float)height);
 }
 
@@ -150,11 +703,71 @@ void GameState::KeyCallback(int key, int scancode, int action, int mods) {
 			window_->Close();
 		}
 		break;
+	case GLFW_KEY_F2:
+		if (action == GLFW_PRESS) {
+			occlusion_culling_ = !occlusion_culling_;
+		}
+		break;
 	case GLFW_KEY_F3:
 		if (action == GLFW_PRESS) {
 			show_debug_info_ = !show_debug_info_;
 		}
 		break;
+	case GLFW_KEY_F4:
+		if (action == GLFW_PRESS) {
+			farthest_first_ = !farthest_first_;
+		}
+		break;
+	case GLFW_KEY_F5:
+		if (action == GLFW_PRESS) {
+			if (edit_benchmark_) {
+				edit_benchmark_ = nullptr;
+			} else {
+				edit_benchmark_ = std::make_unique<EditBenchmark>(chunk_manager_.get(), 4000, 32);
+			}
+		}
+		break;
+	case GLFW_KEY_F8:
+		if (action == GLFW_PRESS) {
+			if (flythrough_) {
+				flythrough_ = nullptr;
+				std::cout << "[Flythrough benchmark] Aborted" << std::endl;
+			} else {
+				StartFlythrough(3000, 0);
+			}
+		}
+		break;
+	case GLFW_KEY_F7:
+		if (action == GLFW_PRESS) {
+			bench::RunCollisionBenchmark(*chunk_manager_, player_.position, 1000, 600, kTickRate);
+		}
+		break;
+#ifdef PROFILING
+	case GLFW_KEY_F9:
+		if (action == GLFW_PRESS) {
+			profiler::WriteTrace("trace.json");
+		}
+		break;
+#endif
+	case GLFW_KEY_F6:
+		if (action == GLFW_PRESS) {
+			bench::RunRaycastBenchmark(*chunk_manager_, camera_->GetPosition(), 100000, 64.0f);
+		}
+		break;
+	case GLFW_KEY_F:
+		if (action == GLFW_PRESS) {
+			flying_ = !flying_;
+		}
+		break;
+	case GLFW_KEY_1:
+	case GLFW_KEY_2:
+	case GLFW_KEY_3:
+	case GLFW_KEY_4:
+	case GLFW_KEY_5:
+		if (action == GLFW_PRESS) {
+			place_block_ = (uint8_t)(key - GLFW_KEY_1 + 1); // Block ids after air, in order
+		}
+		break;
 		// Movement
 	case GLFW_KEY_W:
 		input_.z -= input_diff;
@@ -186,6 +799,10 @@ void GameState::KeyCallback(int key, int scancode, int action, int mods) {
 }
 
 void GameState::CursorPosCallback(double x, double y) {
+	if (flythrough_) {
+		window_->SetCursorPos(0.0, 0.0);
+		return;
+	}
 	glm::vec3 rot = camera_->GetRotation();
 
 	rot.x -= (float)y * mouse_sensitivity_; // Pitch
@@ -207,3 +824,21 @@ void GameState::CursorPosCallback(double x, double y) {
 	camera_->SetRotation(rot);
 	window_->SetCursorPos(0.0, 0.0); // Center cursor for camera movement
 }
+
+void GameState::MouseButtonCallback(int button, int action, int mods) {
+	if (action != GLFW_PRESS || !has_target_) {
+		return;
+	}
+
+	switch (button) {
+	case GLFW_MOUSE_BUTTON_LEFT: // Break
+		chunk_manager_->SetBlock(target_.block, 0);
+		break;
+	case GLFW_MOUSE_BUTTON_RIGHT: // Place
+		chunk_manager_->SetBlock(target_.block + target_.normal, place_block_);
+		break;
+	case GLFW_MOUSE_BUTTON_MIDDLE: // Place a light source
+		chunk_manager_->SetBlock(target_.block + target_.normal, block::kLamp);
+		break;
+	}
+}
@@ -1,45 +1,178 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <vector>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <cstdint>
 #include <unordered_map>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include "state.h"
 
 #include <src/utils/hash.h>
+#include <src/utils/triple_buffer.h>
+#include <src/utils/frame_stats.h>
+#include <src/rendering/frame.h>
+#include <src/world/block.h>
+#include <src/world/raycast.h>
+#include <src/physics/physics.h>
 
 class Shader;
 class Texture;
+class Mesh;
+class GpuTimer;
+class FragmentCounter;
+class OcclusionCuller;
 class Camera;
 class Font;
+struct FontAtlas;
 class Text;
+class ShapeBatch;
+class ThreadPool;
 
 class ChunkManager;
+class LodManager;
+class EditBenchmark;
+class FlythroughBenchmark;
 
+// Tick, Update and input callbacks run on the simulation thread, Render runs on the render thread
 class GameState : public State {
 public:
 	GameState(Window* window);
 	~GameState() override;
 
-	void Update(float dt) override;
-	void Render() override;
+	void Tick(float dt) override;
+	void Update(float dt, const FixedTimestep& timestep) override;
+	bool Render() override;
+	bool IsFramePending() const override;
 
 	void FramebufferSizeCallback(int width, int height) override;
 	void KeyCallback(int key, int scancode, int action, int mods) override;
 	void CursorPosCallback(double x, double y) override;
+	void MouseButtonCallback(int button, int action, int mods) override;
+
+	// Starts from a freshly generated world, optionally closing the window once the report is written
+	void StartFlythrough(int num_frames, unsigned int seed, bool quit_when_done = false);
+	// Opaque chunks and tiles are drawn nearest first unless set, also toggled with F4
+	void SetFarthestFirst(bool farthest_first);
+	// Chunks hidden behind others are culled on the GPU once turned on, also toggled with F2
+	void SetOcclusionCulling(bool occlusion_culling);
 
 private:
-	std::unique_ptr<Shader> shader_;
-	std::unique_ptr<Texture> texture_;
-	
+	struct ChunkBuffer {
+		std::unique_ptr<Mesh> mesh;
+		uint64_t mesh_id = 0;
+		uint64_t last_frame = 0;
+		std::array<uint32_t, block::kNumRenderTypes + 1> index_offsets = {}; // Of the uploaded mesh
+		std::shared_ptr<const std::vector<uint32_t>> translucent_indices; // Last sorted order written over the uploaded mesh
+		int cull_slot = -1; // Of the occlusion culler, only chunks are culled
+	};
+
+	// Back to front order of a chunk's translucent faces, kept until the mesh changes or the camera enters another block
+	struct TranslucentSort {
+		uint64_t mesh_id = 0;
+		glm::ivec3 eye_block;
+		std::shared_ptr<const std::vector<uint32_t>> indices;
+		uint64_t last_frame = 0;
+	};
+
+	using ChunkBufferMap = std::unordered_map<glm::ivec3, ChunkBuffer, hash::Hash<glm::ivec3>>;
+
+	struct LodBuffers {
+		ChunkBufferMap buffers; // By tile index
+		std::vector<const Mesh*> draw_list;
+	};
+
+	struct UploadStats {
+		int uploads = 0;
+		int bytes = 0;
+		int waiting = 0; // Meshes over the budget, uploaded in later frames
+	};
+
+private:
+	void MovePlayer(float dt);
+	void AddChunkDraws(Frame& frame);
+	void SortNearestFirst(std::vector<Frame::ChunkDraw>& draws, float cell_size);
+	void UploadChunkMeshes(const Frame& frame);
+	bool UploadChunkMesh(ChunkBuffer& buffer, const ChunkMesh& mesh); // Whether the buffer has a mesh to draw
+	void DrawChunks(block::RenderType type, bool back_to_front, bool culled, int* draw_calls) const; // Culled draws use the occlusion culler's commands
+	void LoadFont(); // Once the atlas generated at startup is ready
+	void RenderFrameTimeGraph(const glm::mat4& ui_proj_mat);
+
+private:
+	// Startup, the pool outlives the font atlas generated on it
+	std::unique_ptr<ThreadPool> loader_;
+	std::future<std::unique_ptr<FontAtlas>> font_atlas_; // Taken by the render thread
+	std::chrono::steady_clock::time_point startup_start_;
+	bool first_frame_logged_ = false;
+
+	// Simulation thread
 	std::unique_ptr<ChunkManager> chunk_manager_;
+	std::unique_ptr<LodManager> lod_manager_;
+
+	std::unique_ptr<Physics> physics_;
 
 	std::unique_ptr<Camera> camera_;
+	PhysicsBody player_;
+	glm::vec3 prev_player_position_; // Position at the previous tick, for interpolation
+	float eye_height_ = 1.62f;
+	float jump_speed_ = 8.5f;
 	glm::ivec3 input_ = { 0, 0, 0 };
 	bool sprinting_ = false;
+	bool flying_ = true;
 	float mouse_sensitivity_ = 0.001f;
 
+	bool has_target_ = false;
+	raycast::Hit target_; // Block the camera is looking at
+	float reach_ = 8.0f;
+	uint8_t place_block_ = block::kStone; // Selected with the number keys
+
+	int tick_count_ = 0;
+	float tps_time_ = 0.0f;
+	int tps_ = 0;
+	float tick_ms_ = 0.0f; // Time spent in ticks since the last published frame
+
+	bool show_debug_info_ = true;
+
+	std::unique_ptr<EditBenchmark> edit_benchmark_;
+	std::shared_ptr<FlythroughBenchmark> flythrough_; // Shared with the render thread, which records the samples
+	int flythrough_frame_ = 0;
+	bool quit_after_flythrough_ = false;
+
+	uint64_t published_loads_ = 0; // Chunk manager counters at the last published frame
+	uint64_t published_meshes_ = 0;
+
+	std::unordered_map<glm::ivec3, TranslucentSort, hash::Hash<glm::ivec3>> translucent_sorts_;
+	uint64_t published_frames_ = 0;
+	std::vector<uint32_t> sort_keys_; // Scratch for SortNearestFirst
+	std::vector<uint32_t> sort_scratch_;
+	std::vector<Frame::ChunkDraw> sorted_draws_;
+	bool farthest_first_ = false; // Opaque draw order flipped, to measure what nearest first saves
+	bool occlusion_culling_ = false;
+
+	// Handoff between threads
+	TripleBuffer<Frame> frames_;
+	std::atomic<bool> flythrough_done_ = false; // Set by the render thread once the report is written
+
+	// Render thread
+	std::unique_ptr<Shader> shader_;
+	std::unique_ptr<Shader> cutout_shader_;
+	std::unique_ptr<Shader> lod_shader_;
+	std::unique_ptr<Texture> texture_;
+
+	ChunkBufferMap chunk_buffers_;
+	uint64_t render_frame_ = 0;
+	std::vector<const ChunkBuffer*> draw_list_; // Nearest first, also the order of the occlusion culler's chunks
+	std::unique_ptr<OcclusionCuller> occlusion_culler_;
+	std::vector<LodBuffers> lod_buffers_; // Per level of detail, from level 1 up
+	int max_uploads_per_frame_ = 32;
+	UploadStats upload_stats_;
+	int viewport_width_ = 0;
+	int viewport_height_ = 0;
+
 	std::unique_ptr<Shader> text_shader_;
 	std::unique_ptr<Font> font_;
 
@@ -47,8 +180,26 @@ private:
 	int fps_count_ = 0;
 	float fps_time_ = 0.0f;
 	int fps_ = 0;
+	std::chrono::steady_clock::time_point last_render_time_ = std::chrono::steady_clock::now();
 
 	std::unique_ptr<Text> debug_text_;
-	bool show_debug_info_ = true;
+
+	FrameStats frame_stats_;
+	FrameStats::Summary frame_summary_;
+	std::unique_ptr<Shader> shape_shader_;
+	std::unique_ptr<ShapeBatch> shape_batch_;
+
+	static inline constexpr int kChunkPass = 0;
+	static inline constexpr int kUIPass = 1;
+	static inline constexpr int kUploadPass = 2;
+	static inline constexpr int kLodPass = 3;
+	static inline constexpr int kTranslucentPass = 4;
+	static inline constexpr int kCullPass = 5;
+	std::unique_ptr<GpuTimer> gpu_timer_;
+	std::unique_ptr<FragmentCounter> fragment_counter_; // Same passes as the timer
+
+	float sim_ms_ = 0.0f;
+	float render_ms_ = 0.0f;
+	float frame_ms_ = 0.0f;
 
 };
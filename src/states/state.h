@@ -2,17 +2,25 @@
 
 #include <src/window.h>
 
+class FixedTimestep;
+
 class State {
 public:
 	State(Window* window);
 	virtual ~State();
 
-	virtual void Update(float dt) = 0;
-	virtual void Render() = 0;
+	virtual void Tick(float dt) = 0; // Simulation step at a fixed rate
+	virtual void Update(float dt, const FixedTimestep& timestep) = 0; // Once per frame, after ticks
+	virtual bool Render() = 0; // Returns false if there was no new frame to draw
+	virtual bool IsFramePending() const { return false; } // True while the last published frame hasn't been picked up by Render
 
 	virtual void FramebufferSizeCallback(int width, int height) {}
 	virtual void KeyCallback(int key, int scancode, int action, int mods) {}
 	virtual void CursorPosCallback(double x, double y) {}
+	virtual void MouseButtonCallback(int button, int action, int mods) {}
+
+public:
+	static inline constexpr float kTickRate = 60.0f;
 
 protected:
 	Window* window_;
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <vector>
 #include <cmath>
+#include <chrono>
+#include <future>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
@@ -12,12 +14,16 @@
 #include <src/utils/rect_pack.h>
 #include <src/utils/math.h>
 #include <src/text/sdf.h>
+#include <src/utils/profiler.h>
+#include <src/utils/thread_pool.h>
 
 const int Font::kFirstChar = 32;
 const int Font::kNumChars = 128 - Font::kFirstChar;
 
 // Generate font with specified height
 Font::Font(const std::string& file_path, int font_height) {
+	PROFILE_SCOPE("Font::Font");
+
 	// TODO: Move this outside
 	FT_Library library;
 	if (FT_Init_FreeType(&library)) {
@@ -110,6 +116,8 @@ Font::Font(const std::string& file_path, int font_height) {
 
 // Generate font that fits into specified atlas size
 Font::Font(const std::string& file_path, int atlas_width, int atlas_height) {
+	PROFILE_SCOPE("Font::Font");
+
 	// TODO: Move this outside
 	FT_Library library;
 	if (FT_Init_FreeType(&library)) {
@@ -228,7 +236,86 @@ Font::Font(const std::string& file_path, int atlas_width, int atlas_height) {
 
 
 // Generate font that fits into specified atlas size
-Font::Font(const std::string& file_path, int atlas_width, int atlas_height, int spread) {
+Font::Font(const std::string& file_path, int atlas_width, int atlas_height, int spread) :
+	Font(GenerateSdfAtlas(file_path, atlas_width, atlas_height, spread))
+{
+}
+
+Font::Font(FontAtlas atlas) {
+	atlas_ = std::make_unique<Texture>(atlas.width, atlas.height, 1, atlas.pixels.data());
+	characters_ = std::move(atlas.characters);
+}
+
+namespace {
+
+struct GlyphGroup {
+	std::map<unsigned char, FontCharacter> characters;
+	int area = 0;
+};
+
+// Every stride-th glyph from first on, rendered at render_height into its rectangle of the atlas
+// Each group opens the font itself, FreeType faces can't be shared between threads
+GlyphGroup RenderSdfGlyphs(const std::string& file_path, const std::vector<rect_pack::Rectangle>& rects, size_t first, size_t stride, int render_height, int final_height, int spread, FontAtlas* atlas) {
+	GlyphGroup group;
+	FT_Library library;
+	if (FT_Init_FreeType(&library)) {
+		std::cerr << "[ERROR] Failed to initialize FreeType library" << std::endl;
+		return group;
+	}
+	FT_Face face;
+	if (FT_New_Face((FT_Library)library, file_path.c_str(), 0, &face)) {
+		std::cerr << "[ERROR] Failed to load font " << file_path << std::endl;
+		FT_Done_FreeType(library);
+		return group;
+	}
+
+	FT_Set_Pixel_Sizes(face, 0, render_height);
+	const glm::vec2 atlas_size(atlas->width, atlas->height);
+	for (size_t i = first; i < rects.size(); i += stride) {
+		const rect_pack::Rectangle& rect = rects[i];
+		const unsigned char c = rect.id;
+
+		if (FT_Load_Char(face, c, FT_LOAD_DEFAULT)) {
+			std::cerr << "[ERROR] Failed to load Glyph " << c << std::endl;
+			continue;
+		}
+		if (FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL)) {
+			std::cerr << "[ERROR] Failed to render Glyph " << c << std::endl;
+			continue;
+		}
+
+		group.area += rect.w * rect.h;
+
+		std::unique_ptr<uint8_t[]> sdf_data(new uint8_t[rect.w * rect.h]);
+		const FT_Bitmap& bitmap = face->glyph->bitmap; // Alias for readability
+		sdf::GenerateSDF(spread, bitmap.buffer, bitmap.width, bitmap.rows, sdf_data.get(), rect.w, rect.h);
+
+		// Rectangles don't overlap, so groups write into the atlas without locking
+		for (int row = 0; row < rect.h; ++row) {
+			std::copy_n(sdf_data.get() + row * rect.w, rect.w, atlas->pixels.data() + (size_t)(rect.y + row) * atlas->width + rect.x);
+		}
+
+		const float font_size = (float)final_height;
+		group.characters.insert({ c, {
+			glm::vec2(rect.x, rect.y) / atlas_size,
+			glm::vec2(rect.x + rect.w, rect.y + rect.h) / atlas_size,
+			glm::vec2(rect.w, rect.h) / font_size,
+			glm::vec2(face->glyph->bitmap_left, face->glyph->bitmap_top) / (float)render_height,
+			(float)(face->glyph->advance.x >> 6) / (float)render_height
+		} });
+	}
+
+	FT_Done_Face(face);
+	FT_Done_FreeType(library);
+	return group;
+}
+
+} // namespace
+
+FontAtlas Font::GenerateSdfAtlas(const std::string& file_path, int atlas_width, int atlas_height, int spread, ThreadPool* pool) {
+	PROFILE_SCOPE("Font::GenerateSdfAtlas");
+	const auto time_start = std::chrono::steady_clock::now();
+
 	// TODO: Move this outside
 	FT_Library library;
 	if (FT_Init_FreeType(&library)) {
@@ -291,57 +378,44 @@ Font::Font(const std::string& file_path, int atlas_width, int atlas_height, int
 	}
 	int final_height = candidate_height;
 
-	// TODO: Zero-initialize texture atlas (is this even necessary?)
-	atlas_ = std::make_unique<Texture>(atlas_width, atlas_height, 1, nullptr);
-
-	// Load glyphs and copy them into atlas
-	int glyph_area_sum = 0;
-	int render_height = 2048;
-	FT_Set_Pixel_Sizes(face, 0, render_height);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable 4-byte alignment restriction
-	for (const auto& rect : rects) {
-		const unsigned char c = rect.id;
-
-		if (FT_Load_Char(face, c, FT_LOAD_DEFAULT)) {
-			std::cerr << "[ERROR] Failed to load Glyph " << c << std::endl;
-			continue;
-		}
-		if (FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL)) {
-			std::cerr << "[ERROR] Failed to render Glyph " << c << std::endl;
-			continue;
-		}
-
-		glyph_area_sum += rect.w * rect.h;
-
-		std::unique_ptr<uint8_t[]> sdf_data(new uint8_t[rect.w * rect.h]);
-		const FT_Bitmap& bitmap = face->glyph->bitmap; // Alias for readability
-		sdf::GenerateSDF(spread, bitmap.buffer, bitmap.width, bitmap.rows, sdf_data.get(), rect.w, rect.h);
+	FT_Done_Face(face);
+	FT_Done_FreeType(library);
 
-		// This is faster than creating atlas buffer on the CPU (tested using std::copy)
-		atlas_->SubImage(rect.x, rect.y, rect.w, rect.h, sdf_data.get());
+	FontAtlas atlas;
+	atlas.width = atlas_width;
+	atlas.height = atlas_height;
+	atlas.pixels.assign((size_t)atlas_width * atlas_height, 0);
+
+	// Rendering glyphs at a high resolution for accurate distances is the slow part, so glyphs are interleaved between threads
+	const int render_height = 2048;
+	const int num_groups = pool ? pool->GetNumThreads() + 1 : 1;
+	std::vector<std::future<GlyphGroup>> futures;
+	for (int group = 1; group < num_groups; ++group) {
+		futures.push_back(pool->Submit([&, group]() {
+			return RenderSdfGlyphs(file_path, rects, group, num_groups, render_height, final_height, spread, &atlas);
+		}));
+	}
+	std::vector<GlyphGroup> groups;
+	groups.push_back(RenderSdfGlyphs(file_path, rects, 0, num_groups, render_height, final_height, spread, &atlas));
+	for (auto& future : futures) {
+		groups.push_back(future.get());
+	}
 
-		const glm::vec2 atlas_size(atlas_width, atlas_height);
-		const float font_size = (float)final_height;
-		characters_.insert({ c, {
-			glm::vec2(rect.x, rect.y) / atlas_size,
-			glm::vec2(rect.x + rect.w, rect.y + rect.h) / atlas_size,
-			glm::vec2(rect.w, rect.h) / font_size,
-			glm::vec2(face->glyph->bitmap_left, face->glyph->bitmap_top) / (float)render_height,
-			(float)(face->glyph->advance.x >> 6) / (float)render_height
-		} });
+	int glyph_area_sum = 0;
+	for (GlyphGroup& group : groups) {
+		glyph_area_sum += group.area;
+		atlas.characters.merge(group.characters);
 	}
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4); // Re-enable default alignment
 
 	float compression_ratio = (float)glyph_area_sum / (atlas_width * atlas_height);
 	std::cout << "[Font atlas] " <<
 		"resolution=" << atlas_width << "x" << atlas_height << ", " <<
 		"ratio=" << compression_ratio << ", " <<
-		"iters=" << downscale_iters << std::endl;
-
+		"iters=" << downscale_iters << ", " <<
+		"threads=" << num_groups << ", " <<
+		"ms=" << std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - time_start).count() << std::endl;
 
-	FT_Done_Face(face);
-
-	FT_Done_FreeType(library);
+	return atlas;
 }
 
 
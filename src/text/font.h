@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 #include <map>
 #include <glm/glm.hpp>
 
 class Texture;
+class ThreadPool;
 
 struct FontCharacter {
 	glm::vec2 uv_min_;
@@ -15,14 +18,26 @@ struct FontCharacter {
 	float advance_;
 };
 
+// Glyphs and pixels of a font atlas, generated without OpenGL so it can be built off the thread owning the context
+struct FontAtlas {
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> pixels; // Single channel, rows in texture order
+	std::map<unsigned char, FontCharacter> characters;
+};
 
 class Font {
 public:
 	Font(const std::string& file_path, int nominal_height);
 	Font(const std::string& file_path, int atlas_width, int atlas_height);
 	Font(const std::string& file_path, int atlas_width, int atlas_height, int spread);
+	explicit Font(FontAtlas atlas); // Uploads the atlas
 	~Font();
 
+	// Signed distance field atlas of the largest font that fits, glyphs are split between the pool's threads and the calling one
+	// Must not be called from one of the pool's threads, it waits for the pool
+	static FontAtlas GenerateSdfAtlas(const std::string& file_path, int atlas_width, int atlas_height, int spread, ThreadPool* pool = nullptr);
+
 	const FontCharacter& GetCharacter(char c) const;
 	const std::unique_ptr<Texture>& GetAtlas() const;
 
@@ -6,6 +6,7 @@
 #include <src/text/font.h>
 #include <src/gl/texture.h>
 #include <src/gl/shader.h>
+#include <src/utils/profiler.h>
 
 struct TextVertex {
 	GLfloat x;
@@ -48,6 +49,8 @@ void Text::SetText(const std::string& text) {
 }
 
 void Text::UpdateVertices() {
+	PROFILE_SCOPE("Text::UpdateVertices");
+
 	std::vector<TextVertex> vertices(6 * text_.length());
 	int i = 0;
 	float advance = 0.0f;
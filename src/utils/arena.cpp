@@ -0,0 +1,30 @@
+#include "arena.h"
+
+#include <cstdint>
+
+Arena::Arena(size_t capacity) : memory_(new std::byte[capacity]), capacity_(capacity) {
+
+}
+
+void* Arena::Allocate(size_t bytes, size_t alignment) {
+	uintptr_t base = reinterpret_cast<uintptr_t>(memory_.get());
+	uintptr_t aligned = (base + used_ + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	size_t offset = (size_t)(aligned - base);
+	if (offset + bytes > capacity_) {
+		return nullptr;
+	}
+	used_ = offset + bytes;
+	return memory_.get() + offset;
+}
+
+void Arena::Reset() {
+	used_ = 0;
+}
+
+size_t Arena::GetCapacity() const {
+	return capacity_;
+}
+
+size_t Arena::GetUsed() const {
+	return used_;
+}
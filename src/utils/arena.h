@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+// Bump allocator over a single block that is allocated up front
+// Allocations are never freed individually, Reset releases all of them at once
+class Arena {
+public:
+	explicit Arena(size_t capacity);
+
+	// Returns nullptr if the arena is full
+	template<typename T>
+	T* Allocate(size_t count) {
+		return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+	}
+	void* Allocate(size_t bytes, size_t alignment);
+
+	void Reset();
+
+	size_t GetCapacity() const;
+	size_t GetUsed() const;
+
+private:
+	std::unique_ptr<std::byte[]> memory_;
+	size_t capacity_;
+	size_t used_ = 0;
+
+};
@@ -1,8 +1,15 @@
 #include "file.h"
 
+#include <cstdio>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 namespace file {
 
@@ -17,4 +24,72 @@ std::string ReadTextFile(const std::string& path) {
 	return contents.str();
 }
 
+bool ReadBinaryFile(const std::string& path, std::vector<uint8_t>* contents) {
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	contents->resize((size_t)file.tellg());
+	file.seekg(0);
+	return (bool)file.read((char*)contents->data(), (std::streamsize)contents->size());
+}
+
+bool WriteBinaryFile(const std::string& path, const void* data, size_t size) {
+	const std::string temp_path = path + ".tmp";
+	{
+		std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file || !file.write((const char*)data, (std::streamsize)size)) {
+			return false;
+		}
+	}
+	std::remove(path.c_str()); // Rename doesn't replace existing files on Windows
+	return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+	if (mapped_) {
+		munmap((void*)data_, size_);
+	}
+#endif
+}
+
+bool MappedFile::Open(const std::string& path) {
+#if !defined(_WIN32)
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+		close(fd);
+		return false;
+	}
+	void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // The mapping keeps the file open
+	if (data == MAP_FAILED) {
+		return false;
+	}
+	data_ = (const uint8_t*)data;
+	size_ = (size_t)info.st_size;
+	mapped_ = true;
+	return true;
+#else
+	if (!ReadBinaryFile(path, &contents_)) {
+		return false;
+	}
+	data_ = contents_.data();
+	size_ = contents_.size();
+	return true;
+#endif
+}
+
+const uint8_t* MappedFile::GetData() const {
+	return data_;
+}
+
+size_t MappedFile::GetSize() const {
+	return size_;
+}
+
 } // namespace file
@@ -1,9 +1,37 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace file {
 
 std::string ReadTextFile(const std::string& path);
+// Returns false if the file can't be read, unlike ReadTextFile which throws, for files that may be missing
+bool ReadBinaryFile(const std::string& path, std::vector<uint8_t>* contents);
+// Written to a temporary file first and renamed, so readers never see a partial file
+bool WriteBinaryFile(const std::string& path, const void* data, size_t size);
+
+// Read-only view of a whole file, memory mapped where the platform supports it and read into memory otherwise
+class MappedFile {
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+
+	bool Open(const std::string& path);
+
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+
+private:
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+	bool mapped_ = false;
+	std::vector<uint8_t> contents_; // Without memory mapping
+
+};
 
 } // namespace file
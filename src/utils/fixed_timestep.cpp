@@ -0,0 +1,51 @@
+#include "fixed_timestep.h"
+
+FixedTimestep::FixedTimestep(float tick_rate, int max_ticks_per_frame) {
+	tick_dt_ = 1.0f / tick_rate;
+	max_ticks_per_frame_ = max_ticks_per_frame;
+}
+
+int FixedTimestep::Advance(float dt) {
+	accumulator_ += dt;
+
+	ticks_ = 0;
+	while (accumulator_ >= tick_dt_ && ticks_ < max_ticks_per_frame_) {
+		accumulator_ -= tick_dt_;
+		++ticks_;
+	}
+
+	// Drop whole ticks we can't catch up on, instead of spiralling into ever longer frames
+	while (accumulator_ >= tick_dt_) {
+		accumulator_ -= tick_dt_;
+		++dropped_ticks_;
+	}
+
+	return ticks_;
+}
+
+float FixedTimestep::GetTickDeltaTime() const {
+	return tick_dt_;
+}
+
+// Fraction of a tick between the last simulated state and the current time, used for interpolation
+float FixedTimestep::GetAlpha() const {
+	return accumulator_ / tick_dt_;
+}
+
+// Time that was accumulated before this frame's ticks were taken out of it, in seconds
+float FixedTimestep::GetBacklog() const {
+	return accumulator_ + ticks_ * tick_dt_;
+}
+
+// Time left after the last Advance until another tick is due, in seconds
+float FixedTimestep::GetTimeToNextTick() const {
+	return tick_dt_ - accumulator_;
+}
+
+int FixedTimestep::GetTicks() const {
+	return ticks_;
+}
+
+int FixedTimestep::GetDroppedTicks() const {
+	return dropped_ticks_;
+}
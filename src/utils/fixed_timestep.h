@@ -0,0 +1,26 @@
+#pragma once
+
+// Accumulates frame time and converts it into a whole number of fixed simulation ticks
+// - https://gafferongames.com/post/fix_your_timestep/
+class FixedTimestep {
+public:
+	FixedTimestep(float tick_rate, int max_ticks_per_frame = 5);
+
+	// Returns the number of ticks that should be simulated this frame
+	int Advance(float dt);
+
+	float GetTickDeltaTime() const;
+	float GetAlpha() const;
+	float GetBacklog() const;
+	float GetTimeToNextTick() const;
+	int GetTicks() const;
+	int GetDroppedTicks() const;
+
+private:
+	float tick_dt_;
+	int max_ticks_per_frame_;
+
+	float accumulator_ = 0.0f;
+	int ticks_ = 0; // Ticks returned by the last call to Advance
+	int dropped_ticks_ = 0; // Ticks skipped in total, because the simulation couldn't keep up
+};
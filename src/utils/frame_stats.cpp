@@ -0,0 +1,64 @@
+#include "frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+FrameStats::FrameStats(int capacity, float hitch_ms) : samples_(capacity), hitch_ms_(hitch_ms) {
+
+}
+
+void FrameStats::Add(float ms) {
+	samples_[head_] = ms;
+	head_ = (head_ + 1) % (int)samples_.size();
+	num_samples_ = std::min(num_samples_ + 1, (int)samples_.size());
+}
+
+void FrameStats::Clear() {
+	head_ = 0;
+	num_samples_ = 0;
+}
+
+FrameStats::Summary FrameStats::Compute() const {
+	Summary summary;
+	if (num_samples_ == 0) {
+		return summary;
+	}
+
+	sorted_.resize(num_samples_);
+	double sum = 0.0;
+	for (int i = 0; i < num_samples_; ++i) {
+		sorted_[i] = GetSample(i);
+		sum += sorted_[i];
+		if (sorted_[i] > hitch_ms_) {
+			++summary.hitches;
+		}
+	}
+	std::sort(sorted_.begin(), sorted_.end());
+
+	// Nearest-rank percentile
+	auto percentile = [&](float p) {
+		int rank = (int)std::ceil(p * num_samples_) - 1;
+		return sorted_[std::clamp(rank, 0, num_samples_ - 1)];
+	};
+
+	summary.num_frames = num_samples_;
+	summary.mean_ms = (float)(sum / num_samples_);
+	summary.p50_ms = percentile(0.50f);
+	summary.p95_ms = percentile(0.95f);
+	summary.p99_ms = percentile(0.99f);
+	summary.max_ms = sorted_.back();
+	return summary;
+}
+
+int FrameStats::GetNumSamples() const {
+	return num_samples_;
+}
+
+float FrameStats::GetSample(int i) const {
+	int capacity = (int)samples_.size();
+	return samples_[(head_ - num_samples_ + i + capacity) % capacity];
+}
+
+float FrameStats::GetHitchThreshold() const {
+	return hitch_ms_;
+}
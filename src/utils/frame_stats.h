@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+// Rolling window of frame times, averages alone hide stutters
+class FrameStats {
+public:
+	struct Summary {
+		int num_frames = 0;
+		float mean_ms = 0.0f;
+		float p50_ms = 0.0f;
+		float p95_ms = 0.0f;
+		float p99_ms = 0.0f;
+		float max_ms = 0.0f;
+		int hitches = 0; // Frames above the hitch threshold
+	};
+
+	FrameStats(int capacity = 4096, float hitch_ms = 33.3f);
+
+	void Add(float ms);
+	void Clear();
+
+	// Sorts a copy of the window, so call it once in a while rather than every frame
+	Summary Compute() const;
+
+	int GetNumSamples() const;
+	float GetSample(int i) const; // 0 is the oldest sample in the window
+	float GetHitchThreshold() const;
+
+private:
+	std::vector<float> samples_;
+	int head_ = 0; // Next sample to overwrite
+	int num_samples_ = 0;
+	float hitch_ms_;
+
+	mutable std::vector<float> sorted_;
+
+};
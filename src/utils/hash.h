@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <glm/vec3.hpp>
 
 namespace hash {
@@ -19,4 +21,13 @@ struct Hash<glm::vec<3, T, Q>> {
 
 };
 
+// FNV-1a, for keys of file contents like cached assets rather than for hash tables
+inline uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
 }; // namespace hash
@@ -0,0 +1,193 @@
+#include "image.h"
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include <src/utils/hash.h>
+#include <src/utils/debug.h>
+
+namespace image {
+
+namespace {
+
+const char* const kCacheDirectory = "cache/images";
+constexpr uint32_t kCacheMagic = 0x4d49434d; // "MCIM"
+constexpr uint32_t kCacheVersion = 1; // Bump when the format or the mipmap filter changes
+
+// Start of a cache file, followed by the pixels of every level
+struct CacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	int32_t width;
+	int32_t height;
+	int32_t num_components;
+	int32_t num_levels;
+};
+
+// Lays out the levels of the image from the given size down, returns the size of all of them in bytes
+size_t SetLevels(Image* image, int width, int height, int num_levels) {
+	image->levels.clear();
+	size_t offset = 0;
+	for (int level = 0; level < num_levels; ++level) {
+		image->levels.push_back({ width, height, offset });
+		offset += (size_t)width * height * image->num_components;
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+	return offset;
+}
+
+std::unique_ptr<Image> ReadCache(const std::string& path, uint64_t key) {
+	auto mapping = std::make_unique<file::MappedFile>();
+	if (!mapping->Open(path) || mapping->GetSize() < sizeof(CacheHeader)) {
+		return nullptr;
+	}
+	CacheHeader header;
+	std::memcpy(&header, mapping->GetData(), sizeof(header));
+	if (header.magic != kCacheMagic || header.version != kCacheVersion || header.key != key ||
+		header.width <= 0 || header.height <= 0 || header.num_components < 1 || header.num_components > 4 ||
+		header.num_levels < 1 || header.num_levels > GetMaxLevels(header.width, header.height)) {
+		return nullptr;
+	}
+
+	auto image = std::make_unique<Image>();
+	image->num_components = header.num_components;
+	const size_t size = SetLevels(image.get(), header.width, header.height, header.num_levels);
+	if (mapping->GetSize() != sizeof(CacheHeader) + size) {
+		return nullptr; // Truncated
+	}
+	image->pixels = mapping->GetData() + sizeof(CacheHeader);
+	image->mapping = std::move(mapping);
+	return image;
+}
+
+bool WriteCache(const std::string& path, uint64_t key, const Image& image) {
+	const Level& last = image.levels.back();
+	const size_t size = last.offset + (size_t)last.width * last.height * image.num_components;
+	CacheHeader header = { kCacheMagic, kCacheVersion, key, image.GetWidth(), image.GetHeight(), image.num_components, image.GetNumLevels() };
+	std::vector<uint8_t> contents(sizeof(header) + size);
+	std::memcpy(contents.data(), &header, sizeof(header));
+	std::memcpy(contents.data() + sizeof(header), image.pixels, size);
+
+	std::error_code error;
+	std::filesystem::create_directories(kCacheDirectory, error);
+	return file::WriteBinaryFile(path, contents.data(), contents.size());
+}
+
+} // namespace
+
+std::unique_ptr<Image> Decode(const uint8_t* data, size_t size) {
+	// OpenGL's first row is the bottom one, the global flip setting isn't safe to use from worker threads
+	stbi_set_flip_vertically_on_load_thread(1);
+	int width, height, num_components;
+	uint8_t* pixels = stbi_load_from_memory(data, (int)size, &width, &height, &num_components, 0);
+	if (!pixels) {
+		return nullptr;
+	}
+	auto image = std::make_unique<Image>();
+	image->num_components = num_components;
+	image->storage.assign(pixels, pixels + SetLevels(image.get(), width, height, 1));
+	image->pixels = image->storage.data();
+	stbi_image_free(pixels);
+	return image;
+}
+
+void GenerateMipmaps(Image* image, int num_levels) {
+	const int width = image->GetWidth();
+	const int height = image->GetHeight();
+	const int c = image->num_components;
+	num_levels = std::clamp(num_levels, 1, GetMaxLevels(width, height));
+
+	std::vector<uint8_t> storage(SetLevels(image, width, height, num_levels));
+	std::memcpy(storage.data(), image->pixels, (size_t)width * height * c);
+	for (int level = 1; level < num_levels; ++level) {
+		const Level& src = image->levels[level - 1];
+		const Level& dst = image->levels[level];
+		const uint8_t* src_pixels = storage.data() + src.offset;
+		uint8_t* dst_pixels = storage.data() + dst.offset;
+		for (int y = 0; y < dst.height; ++y) {
+			// A side of 1 halves to 1, then both source rows or columns are the same
+			const uint8_t* row0 = src_pixels + (size_t)std::min(2 * y, src.height - 1) * src.width * c;
+			const uint8_t* row1 = src_pixels + (size_t)std::min(2 * y + 1, src.height - 1) * src.width * c;
+			for (int x = 0; x < dst.width; ++x) {
+				const int x0 = std::min(2 * x, src.width - 1) * c;
+				const int x1 = std::min(2 * x + 1, src.width - 1) * c;
+				for (int i = 0; i < c; ++i) {
+					const int sum = row0[x0 + i] + row0[x1 + i] + row1[x0 + i] + row1[x1 + i];
+					dst_pixels[((size_t)y * dst.width + x) * c + i] = (uint8_t)((sum + 2) / 4);
+				}
+			}
+		}
+	}
+	image->storage.swap(storage);
+	image->pixels = image->storage.data();
+	image->mapping = nullptr;
+}
+
+int GetMaxLevels(int width, int height) {
+	int levels = 1;
+	while ((std::max(width, height) >> levels) > 0) {
+		++levels;
+	}
+	return levels;
+}
+
+std::unique_ptr<Image> Load(const std::string& path, int num_levels, LoadStats* stats) {
+	LoadStats local_stats;
+	if (!stats) {
+		stats = &local_stats;
+	}
+	*stats = {};
+	const auto time_start = std::chrono::steady_clock::now();
+	auto time_step = time_start;
+	auto lap = [&time_step]() {
+		const auto time_now = std::chrono::steady_clock::now();
+		const float ms = std::chrono::duration<float, std::milli>(time_now - time_step).count();
+		time_step = time_now;
+		return ms;
+	};
+
+	// Keyed by the contents rather than the modification time, which copying the data directory doesn't keep
+	std::vector<uint8_t> source;
+	if (!file::ReadBinaryFile(path, &source)) {
+		std::cerr << "[ERROR] Can't read image " << path << std::endl;
+		return nullptr;
+	}
+	uint64_t key = hash::Fnv1a(source.data(), source.size());
+	key = hash::Fnv1a(&num_levels, sizeof(num_levels), key);
+	const std::string cache_path = debug::FormatString("%s/%016llx.bin", kCacheDirectory, (unsigned long long)key);
+	stats->read_ms = lap();
+
+	std::unique_ptr<Image> image = ReadCache(cache_path, key);
+	if (image) {
+		stats->cache_hit = true;
+		stats->cache_ms = lap();
+	} else {
+		image = Decode(source.data(), source.size());
+		if (!image) {
+			std::cerr << "[ERROR] Can't decode image " << path << std::endl;
+			return nullptr;
+		}
+		stats->decode_ms = lap();
+		GenerateMipmaps(image.get(), num_levels);
+		stats->mipmap_ms = lap();
+		if (!WriteCache(cache_path, key, *image)) {
+			std::cerr << "[WARNING] Can't write image cache " << cache_path << std::endl;
+		}
+		stats->cache_ms = lap();
+	}
+	stats->total_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - time_start).count();
+
+	// One write, lines of images loaded in parallel don't interleave
+	std::cout << debug::FormatString("[Image] path=%s, cache=%s, size=%dx%d, levels=%d, read_ms=%.2f, decode_ms=%.2f, mipmap_ms=%.2f, cache_ms=%.2f, total_ms=%.2f\n",
+		path.c_str(), stats->cache_hit ? "hit" : "miss", image->GetWidth(), image->GetHeight(), image->GetNumLevels(),
+		stats->read_ms, stats->decode_ms, stats->mipmap_ms, stats->cache_ms, stats->total_ms) << std::flush;
+	return image;
+}
+
+} // namespace image
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <src/utils/file.h>
+
+// 8 bit images with their mip chain, decoded off the GL thread and cached in a ready to upload format
+namespace image {
+
+struct Level {
+	int width;
+	int height;
+	size_t offset; // Into the image's pixels
+};
+
+// Rows are bottom up like OpenGL expects, levels are packed one after another without padding
+struct Image {
+	int num_components = 0;
+	std::vector<Level> levels; // Level 0 is the full image
+	const uint8_t* pixels = nullptr; // Points into storage, or into the mapped cache file
+	std::vector<uint8_t> storage;
+	std::unique_ptr<file::MappedFile> mapping;
+
+	const uint8_t* GetPixels(int level) const {
+		return pixels + levels[level].offset;
+	}
+	int GetWidth() const {
+		return levels[0].width;
+	}
+	int GetHeight() const {
+		return levels[0].height;
+	}
+	int GetNumLevels() const {
+		return (int)levels.size();
+	}
+};
+
+// Where each step of the last Load went, in milliseconds
+struct LoadStats {
+	bool cache_hit = false;
+	float read_ms = 0.0f; // Reading and hashing the source file
+	float decode_ms = 0.0f;
+	float mipmap_ms = 0.0f;
+	float cache_ms = 0.0f; // Mapping the cached image on a hit, writing it on a miss
+	float total_ms = 0.0f;
+};
+
+// Null if the data isn't an image stb can decode
+std::unique_ptr<Image> Decode(const uint8_t* data, size_t size);
+// Box filtered like glGenerateMipmap, up to num_levels levels in total and at most down to 1x1
+void GenerateMipmaps(Image* image, int num_levels);
+// Levels of a full mip chain
+int GetMaxLevels(int width, int height);
+
+// Decodes the file with num_levels mip levels, or maps the cached result of an earlier run for the same file contents
+// Safe to call from worker threads, the timings are logged and returned in stats
+std::unique_ptr<Image> Load(const std::string& path, int num_levels, LoadStats* stats = nullptr);
+
+} // namespace image
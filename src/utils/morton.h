@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Z-order (Morton) codes of 3D coordinates, bits are interleaved as ...zyxzyx
+// Neighbours along every axis stay close in memory, unlike a linear layout that only keeps x runs together
+namespace morton {
+
+inline constexpr uint32_t kMaskX = 0x09249249;
+inline constexpr uint32_t kMaskY = kMaskX << 1;
+inline constexpr uint32_t kMaskZ = kMaskX << 2;
+inline constexpr uint32_t kMasks[] = { kMaskX, kMaskY, kMaskZ };
+
+// Bits of a byte spread out to every third bit
+inline constexpr std::array<uint32_t, 256> kSpreadTable = []() {
+	std::array<uint32_t, 256> table = {};
+	for (uint32_t value = 0; value < 256; ++value) {
+		for (int bit = 0; bit < 8; ++bit) {
+			table[value] |= ((value >> bit) & 1u) << (3 * bit);
+		}
+	}
+	return table;
+}();
+
+// Coordinates below 256
+inline uint32_t EncodeTable(uint32_t x, uint32_t y, uint32_t z) {
+	return kSpreadTable[x] | (kSpreadTable[y] << 1) | (kSpreadTable[z] << 2);
+}
+
+#if defined(__BMI2__)
+inline uint32_t EncodePdep(uint32_t x, uint32_t y, uint32_t z) {
+	return _pdep_u32(x, kMaskX) | _pdep_u32(y, kMaskY) | _pdep_u32(z, kMaskZ);
+}
+#endif
+
+// pdep when the compiler targets BMI2, e.g. with -march=native, the table otherwise
+inline uint32_t Encode(uint32_t x, uint32_t y, uint32_t z) {
+#if defined(__BMI2__)
+	return EncodePdep(x, y, z);
+#else
+	return EncodeTable(x, y, z);
+#endif
+}
+
+// Coordinate along an axis (0 is x), the inverse of the spread
+inline uint32_t Decode(uint32_t code, int axis) {
+	uint32_t v = (code >> axis) & kMaskX;
+	v = (v ^ (v >> 2)) & 0x030c30c3;
+	v = (v ^ (v >> 4)) & 0x0300f00f;
+	v = (v ^ (v >> 8)) & 0xff0000ff;
+	v = (v ^ (v >> 16)) & 0x000003ff;
+	return v;
+}
+
+// Steps the coordinate along an axis by +1 or -1 without decoding it
+// The other axes' bits are filled with ones (or cleared) so the carry (or borrow) skips over them
+inline uint32_t Step(uint32_t code, int axis, int delta) {
+	const uint32_t mask = kMasks[axis];
+	const uint32_t one = 1u << axis;
+	const uint32_t stepped = delta > 0 ? (code | ~mask) + one : (code & mask) - one;
+	return (stepped & mask) | (code & ~mask);
+}
+
+} // namespace morton
@@ -0,0 +1,147 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace profiler {
+
+namespace {
+
+struct Event {
+	const char* name;
+	uint64_t start_ns;
+	uint64_t end_ns;
+};
+
+// Written only by its own thread, oldest events are overwritten when full
+struct ThreadBuffer {
+	static inline constexpr uint64_t kCapacity = 1 << 16;
+
+	std::vector<Event> events = std::vector<Event>(kCapacity);
+	std::atomic<uint64_t> head{ 0 }; // Total number of recorded events
+	int tid = 0;
+	std::atomic<const char*> name{ nullptr };
+};
+
+const auto kEpoch = std::chrono::steady_clock::now();
+
+std::mutex buffers_mutex; // Only taken when a thread records its first event and when writing the trace
+std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+std::shared_ptr<ThreadBuffer> CreateBuffer(const char* name) {
+	auto buffer = std::make_shared<ThreadBuffer>();
+	buffer->name.store(name, std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+	buffer->tid = (int)buffers.size();
+	buffers.push_back(buffer);
+	return buffer;
+}
+
+ThreadBuffer& GetThreadBuffer() {
+	// Shared ownership keeps events of finished threads around until they are written
+	thread_local std::shared_ptr<ThreadBuffer> buffer = CreateBuffer(nullptr);
+	return *buffer;
+}
+
+ThreadBuffer& GetGpuBuffer() {
+	static std::shared_ptr<ThreadBuffer> buffer = CreateBuffer("GPU");
+	return *buffer;
+}
+
+void PushEvent(ThreadBuffer& buffer, const char* name, uint64_t start_ns, uint64_t end_ns) {
+	uint64_t head = buffer.head.load(std::memory_order_relaxed);
+	buffer.events[head % ThreadBuffer::kCapacity] = { name, start_ns, end_ns };
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void WriteEscaped(std::ostream& out, const char* str) {
+	for (; *str; ++str) {
+		if (*str == '"' || *str == '\\') {
+			out << '\\';
+		}
+		out << *str;
+	}
+}
+
+// Trace timestamps are in microseconds
+void WriteMicroseconds(std::ostream& out, uint64_t ns) {
+	out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+}
+
+} // namespace
+
+uint64_t GetTimestamp() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kEpoch).count();
+}
+
+void SetThreadName(const char* name) {
+	GetThreadBuffer().name.store(name, std::memory_order_release);
+}
+
+void RecordZone(const char* name, uint64_t start_ns, uint64_t end_ns) {
+	PushEvent(GetThreadBuffer(), name, start_ns, end_ns);
+}
+
+void RecordGpuZone(const char* name, uint64_t start_ns, uint64_t end_ns) {
+	PushEvent(GetGpuBuffer(), name, start_ns, end_ns);
+}
+
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+bool WriteTrace(const std::string& path) {
+	std::ofstream file(path);
+	if (!file) {
+		std::cerr << "[ERROR] Failed to open trace file " << path << std::endl;
+		return false;
+	}
+	file << "{\"traceEvents\":[\n";
+
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+	bool first = true;
+	int num_events = 0;
+	for (const auto& buffer : buffers) {
+		const char* name = buffer->name.load(std::memory_order_acquire);
+		if (name) {
+			file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->tid << ",\"args\":{\"name\":\"";
+			WriteEscaped(file, name);
+			file << "\"}}";
+			first = false;
+		}
+
+		// The owning thread keeps recording, so copy the events first and drop the ones that were overwritten meanwhile
+		uint64_t head = buffer->head.load(std::memory_order_acquire);
+		uint64_t begin = head > ThreadBuffer::kCapacity ? head - ThreadBuffer::kCapacity : 0;
+		std::vector<Event> events;
+		events.reserve((size_t)(head - begin));
+		for (uint64_t i = begin; i < head; ++i) {
+			events.push_back(buffer->events[i % ThreadBuffer::kCapacity]);
+		}
+		uint64_t new_head = buffer->head.load(std::memory_order_acquire);
+		uint64_t valid_begin = new_head > ThreadBuffer::kCapacity ? new_head - ThreadBuffer::kCapacity : 0;
+
+		for (uint64_t i = std::max(begin, valid_begin); i < head; ++i) {
+			const Event& event = events[(size_t)(i - begin)];
+			file << (first ? "" : ",\n") << "{\"name\":\"";
+			WriteEscaped(file, event.name);
+			file << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->tid << ",\"ts\":";
+			WriteMicroseconds(file, event.start_ns);
+			file << ",\"dur\":";
+			WriteMicroseconds(file, event.end_ns - event.start_ns);
+			file << "}";
+			first = false;
+			++num_events;
+		}
+	}
+
+	file << "\n]}\n";
+	std::cout << "[Profiler] Wrote " << num_events << " events to " << path << std::endl;
+	return true;
+}
+
+} // namespace profiler
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Scoped CPU zones, recorded into per-thread ring buffers and exported as Chrome trace events
+// (chrome://tracing or https://ui.perfetto.dev)
+// Zones compile to nothing unless PROFILING is defined
+#ifdef PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) profiler::Zone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#define PROFILE_THREAD(name) profiler::SetThreadName(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+#endif
+
+namespace profiler {
+
+// Nanoseconds since the profiler was started
+uint64_t GetTimestamp();
+
+// Names are not copied, so they have to outlive the profiler (string literals)
+void SetThreadName(const char* name);
+void RecordZone(const char* name, uint64_t start_ns, uint64_t end_ns);
+// GPU zones go to their own track, only the thread owning the GL context may record them
+void RecordGpuZone(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+bool WriteTrace(const std::string& path);
+
+class Zone {
+public:
+	explicit Zone(const char* name) : name_(name), start_ns_(GetTimestamp()) {}
+	~Zone() { RecordZone(name_, start_ns_, GetTimestamp()); }
+
+	Zone(const Zone&) = delete;
+	Zone& operator=(const Zone&) = delete;
+
+private:
+	const char* name_;
+	uint64_t start_ns_;
+};
+
+} // namespace profiler
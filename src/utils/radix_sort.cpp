@@ -0,0 +1,41 @@
+#include "radix_sort.h"
+
+#include <algorithm>
+
+namespace radix {
+
+void Sort(uint32_t* keys, uint32_t* scratch, size_t count, int first_byte) {
+	// All histograms are counted in a single read of the keys
+	size_t counts[4][256] = {};
+	for (size_t i = 0; i < count; ++i) {
+		const uint32_t key = keys[i];
+		for (int byte = first_byte; byte < 4; ++byte) {
+			++counts[byte][(key >> (8 * byte)) & 0xFF];
+		}
+	}
+
+	uint32_t* src = keys;
+	uint32_t* dst = scratch;
+	for (int byte = first_byte; byte < 4; ++byte) {
+		// A byte that is the same for every key doesn't change the order
+		const int shift = 8 * byte;
+		if (count == 0 || counts[byte][(src[0] >> shift) & 0xFF] == count) {
+			continue;
+		}
+		size_t offsets[256];
+		size_t offset = 0;
+		for (int digit = 0; digit < 256; ++digit) {
+			offsets[digit] = offset;
+			offset += counts[byte][digit];
+		}
+		for (size_t i = 0; i < count; ++i) {
+			dst[offsets[(src[i] >> shift) & 0xFF]++] = src[i];
+		}
+		std::swap(src, dst);
+	}
+	if (src != keys) {
+		std::copy_n(src, count, keys);
+	}
+}
+
+} // namespace radix
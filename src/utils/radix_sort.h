@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Least significant digit radix sort, one counting pass per byte
+// Stable and linear in the number of keys, which beats comparison sorts for the few thousand keys sorted every frame
+namespace radix {
+
+// Sorts 32 bit keys by their bytes in [first_byte, 4), lower bytes are left out of the order and can carry a payload
+// scratch must hold count keys, the result ends up back in keys
+void Sort(uint32_t* keys, uint32_t* scratch, size_t count, int first_byte = 0);
+
+} // namespace radix
@@ -0,0 +1,105 @@
+#include "task_graph.h"
+
+#include <iostream>
+#include <src/utils/debug.h>
+
+int TaskGraph::Add(const char* name, Thread thread, std::function<void()> work, std::initializer_list<int> dependencies) {
+	const int id = (int)tasks_.size();
+	Task& task = tasks_.emplace_back();
+	task.name = name;
+	task.thread = thread;
+	task.work = std::move(work);
+	for (int dependency : dependencies) {
+		tasks_[dependency].dependents.push_back(id);
+		++task.num_dependencies;
+	}
+	return id;
+}
+
+void TaskGraph::Run(ThreadPool& pool) {
+	pool_ = &pool;
+	time_start_ = std::chrono::steady_clock::now();
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	num_remaining_ = (int)tasks_.size();
+	num_scheduled_ = 0;
+	error_ = nullptr;
+	for (Task& task : tasks_) {
+		task.num_waiting = task.num_dependencies;
+	}
+	for (int i = 0; i < (int)tasks_.size(); ++i) {
+		if (tasks_[i].num_dependencies == 0) {
+			Schedule(i);
+		}
+	}
+
+	// Run main tasks as they become ready, until everything is done or a task failed and nothing is running anymore
+	while (true) {
+		condition_.wait(lock, [this]() { return !main_queue_.empty() || num_remaining_ == 0 || (error_ && num_scheduled_ == 0); });
+		if (main_queue_.empty()) {
+			break;
+		}
+		const int task = main_queue_.front();
+		main_queue_.pop_front();
+		if (error_) {
+			--num_scheduled_; // Dropped, its results may be missing
+			continue;
+		}
+		lock.unlock();
+		Execute(task);
+		lock.lock();
+	}
+	total_ms_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - time_start_).count();
+	if (error_) {
+		std::rethrow_exception(error_);
+	}
+}
+
+void TaskGraph::LogTimings(const char* label) const {
+	float sum_ms = 0.0f;
+	for (const Task& task : tasks_) {
+		std::cout << debug::FormatString("[%s] task=%s, thread=%s, start_ms=%.2f, ms=%.2f\n", label, task.name, task.thread == Thread::kMain ? "main" : "worker", task.start_ms, task.duration_ms);
+		sum_ms += task.duration_ms;
+	}
+	// Above 1x tasks overlapped
+	std::cout << debug::FormatString("[%s] tasks=%d, total_ms=%.2f, sum_ms=%.2f (%.2fx)\n", label, (int)tasks_.size(), total_ms_, sum_ms, total_ms_ > 0.0f ? sum_ms / total_ms_ : 0.0f) << std::flush;
+}
+
+void TaskGraph::Schedule(int task) {
+	++num_scheduled_;
+	if (tasks_[task].thread == Thread::kMain) {
+		main_queue_.push_back(task);
+		condition_.notify_all();
+	} else {
+		pool_->Submit([this, task]() { Execute(task); });
+	}
+}
+
+void TaskGraph::Execute(int task) {
+	const auto time_start = std::chrono::steady_clock::now();
+	std::exception_ptr error;
+	try {
+		tasks_[task].work();
+	} catch (...) {
+		error = std::current_exception();
+	}
+	const auto time_end = std::chrono::steady_clock::now();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	Task& info = tasks_[task];
+	info.start_ms = std::chrono::duration<float, std::milli>(time_start - time_start_).count();
+	info.duration_ms = std::chrono::duration<float, std::milli>(time_end - time_start).count();
+	--num_scheduled_;
+	--num_remaining_;
+	if (error && !error_) {
+		error_ = error;
+	}
+	if (!error_) {
+		for (int dependent : info.dependents) {
+			if (--tasks_[dependent].num_waiting == 0) {
+				Schedule(dependent);
+			}
+		}
+	}
+	condition_.notify_all();
+}
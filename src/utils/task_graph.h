@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <condition_variable>
+#include <src/utils/thread_pool.h>
+
+// Tasks with dependencies that run once, each as soon as everything it depends on is done
+// Worker tasks run on a thread pool, main tasks on the thread calling Run, e.g. to create OpenGL objects on the thread owning the context
+class TaskGraph {
+public:
+	enum class Thread {
+		kWorker,
+		kMain,
+	};
+
+	// Dependencies are ids returned by earlier calls
+	int Add(const char* name, Thread thread, std::function<void()> work, std::initializer_list<int> dependencies = {});
+
+	// Returns once every task ran, the first exception thrown by a task is rethrown after the running ones finish
+	void Run(ThreadPool& pool);
+
+	// One line per task in the order they were added, with start times relative to Run
+	void LogTimings(const char* label) const;
+
+private:
+	struct Task {
+		const char* name;
+		Thread thread;
+		std::function<void()> work;
+		std::vector<int> dependents;
+		int num_dependencies = 0;
+		int num_waiting = 0; // Dependencies that haven't finished yet
+		float start_ms = 0.0f;
+		float duration_ms = 0.0f;
+	};
+
+	void Schedule(int task); // With the mutex held
+	void Execute(int task);
+
+private:
+	std::vector<Task> tasks_;
+	ThreadPool* pool_ = nullptr;
+	std::chrono::steady_clock::time_point time_start_;
+	float total_ms_ = 0.0f;
+
+	std::mutex mutex_;
+	std::condition_variable condition_;
+	std::deque<int> main_queue_;
+	int num_scheduled_ = 0; // Scheduled but not finished
+	int num_remaining_ = 0;
+	std::exception_ptr error_;
+
+};
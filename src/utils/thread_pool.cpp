@@ -0,0 +1,44 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int num_threads) {
+	for (int i = 0; i < std::max(num_threads, 1); ++i) {
+		threads_.emplace_back(&ThreadPool::Run, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	condition_.notify_all();
+	for (std::thread& thread : threads_) {
+		thread.join();
+	}
+}
+
+int ThreadPool::GetNumThreads() const {
+	return (int)threads_.size();
+}
+
+int ThreadPool::GetDefaultNumThreads() {
+	return std::max((int)std::thread::hardware_concurrency() - 1, 1);
+}
+
+void ThreadPool::Run() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+			if (tasks_.empty()) {
+				return; // Stopping with nothing left to run
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+		task();
+	}
+}
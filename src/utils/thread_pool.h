@@ -0,0 +1,47 @@
+#pragma once
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+// Fixed set of worker threads running submitted tasks in the order they were submitted
+// Results and exceptions are returned through futures
+class ThreadPool {
+public:
+	explicit ThreadPool(int num_threads);
+	~ThreadPool(); // Runs the tasks still queued before joining
+
+	template<typename F>
+	auto Submit(F&& task) -> std::future<decltype(task())> {
+		// packaged_task is move only, std::function needs a copyable callable
+		auto packaged = std::make_shared<std::packaged_task<decltype(task())()>>(std::forward<F>(task));
+		auto future = packaged->get_future();
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			tasks_.emplace_back([packaged]() { (*packaged)(); });
+		}
+		condition_.notify_one();
+		return future;
+	}
+
+	int GetNumThreads() const;
+
+	// Hardware threads but one, which is left to the thread submitting the tasks
+	static int GetDefaultNumThreads();
+
+private:
+	void Run();
+
+private:
+	std::vector<std::thread> threads_;
+	std::deque<std::function<void()>> tasks_;
+	std::mutex mutex_;
+	std::condition_variable condition_;
+	bool stopping_ = false;
+
+};
@@ -28,3 +28,7 @@ float Timer::GetTime() const {
 float Timer::GetDeltaTime() const {
 	return dt_;
 }
+
+float Timer::GetElapsedTime() const {
+	return std::chrono::duration<float>(std::chrono::steady_clock::now() - time_curr_).count();
+}
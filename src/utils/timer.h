@@ -11,6 +11,7 @@ public:
 
 	float GetTime() const;
 	float GetDeltaTime() const;
+	float GetElapsedTime() const; // Since the last Update
 
 private:
 	float t_ = 0.0f;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Lock-free single producer, single consumer handoff of the most recent value
+// The writer and reader each own one slot, the third slot is exchanged between them
+template<typename T>
+class TripleBuffer {
+public:
+	// Writer
+	T& GetWriteBuffer() {
+		return buffers_[write_];
+	}
+
+	void Publish() {
+		write_ = middle_.exchange(write_ | kDirtyBit, std::memory_order_acq_rel) & kIndexMask;
+	}
+
+	// True if the last published value was picked up by the reader
+	bool IsConsumed() const {
+		return (middle_.load(std::memory_order_acquire) & kDirtyBit) == 0;
+	}
+
+	// Reader
+	bool Update() {
+		if (IsConsumed()) {
+			return false;
+		}
+		read_ = middle_.exchange(read_, std::memory_order_acq_rel) & kIndexMask;
+		return true;
+	}
+
+	const T& GetReadBuffer() const {
+		return buffers_[read_];
+	}
+
+private:
+	static inline constexpr int kIndexMask = 0x3;
+	static inline constexpr int kDirtyBit = 0x4;
+
+	std::array<T, 3> buffers_;
+	std::atomic<int> middle_{ 1 };
+	int write_ = 0;
+	int read_ = 2;
+
+};
@@ -5,12 +5,24 @@
 #include <GLFW/glfw3.h>
 #include <src/states/state.h>
 
-Window::Window(const std::string& title) {
+Window::Window(const std::string& title, bool headless) {
+	headless_ = headless;
+
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-	glfwWindowHint(GLFW_SAMPLES, 4);
+	if (headless_) {
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_PLATFORM_NULL
+		// Without a display server the context can only be created through EGL (e.g. Mesa surfaceless)
+		if (glfwGetPlatform() == GLFW_PLATFORM_NULL) {
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+		}
+#endif
+	} else {
+		glfwWindowHint(GLFW_SAMPLES, 4);
+	}
 
 	glfw_window_ = glfwCreateWindow(width_, height_, title.c_str(), NULL, NULL);
 	if (!glfw_window_) {
@@ -18,9 +30,13 @@ Window::Window(const std::string& title) {
 	}
 
 	glfwSetWindowUserPointer(glfw_window_, this);
+	if (headless_) {
+		return;
+	}
 	glfwSetFramebufferSizeCallback(glfw_window_, FramebufferSizeCallback);
 	glfwSetKeyCallback(glfw_window_, KeyCallback);
 	glfwSetCursorPosCallback(glfw_window_, CursorPosCallback);
+	glfwSetMouseButtonCallback(glfw_window_, MouseButtonCallback);
 }
 
 void Window::Close() const {
@@ -35,15 +51,25 @@ int Window::GetHeight() const {
 	return height_;
 }
 
+bool Window::IsHeadless() const {
+	return headless_;
+}
+
 void Window::SetState(State* state) {
 	state_ = state;
 }
 
 void Window::SetCursorPos(double x, double y) {
+	if (headless_) {
+		return;
+	}
 	glfwSetCursorPos(glfw_window_, x, y);
 }
 
 void Window::SetCursorMode(CursorMode mode) {
+	if (headless_) {
+		return;
+	}
 	int glfw_mode;
 	switch (mode) {
 	case CursorMode::kNormal:
@@ -79,3 +105,10 @@ void Window::CursorPosCallback(GLFWwindow* glfw_window, double x, double y) {
 		window->state_->CursorPosCallback(x, y);
 	}
 }
+
+void Window::MouseButtonCallback(GLFWwindow* glfw_window, int button, int action, int mods) {
+	Window* window = (Window*)glfwGetWindowUserPointer(glfw_window);
+	if (window->state_) {
+		window->state_->MouseButtonCallback(button, action, mods);
+	}
+}
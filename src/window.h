@@ -12,11 +12,13 @@ public:
 		kDisabled
 	};
 
-	Window(const std::string& title);
+	// Headless windows are hidden and don't receive input, rendering should go to an offscreen framebuffer
+	Window(const std::string& title, bool headless = false);
 
 	void Close() const;
 	int GetWidth() const;
 	int GetHeight() const;
+	bool IsHeadless() const;
 
 	void SetState(State* state);
 	void SetCursorPos(double x, double y);
@@ -26,6 +28,7 @@ private:
 	static void FramebufferSizeCallback(GLFWwindow* glfw_window, int width, int height);
 	static void KeyCallback(GLFWwindow* glfw_window, int key, int scancode, int action, int mods);
 	static void CursorPosCallback(GLFWwindow* window, double x, double y);
+	static void MouseButtonCallback(GLFWwindow* glfw_window, int button, int action, int mods);
 
 public:
 	GLFWwindow* glfw_window_ = nullptr; // TODO: Make this private
@@ -33,6 +36,7 @@ public:
 private:
 	int width_ = 1280;
 	int height_ = 720;
+	bool headless_;
 	State* state_ = nullptr;
 
 };
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+
+// Properties of every block id, read in the mesher, lighting and collision inner loops so the table is constexpr
+namespace block {
+
+// How a block's faces are drawn, also the order of a chunk mesh's index ranges
+enum RenderType {
+	kOpaque = 0, // Hides everything behind it, no blending
+	kCutout = 1, // Texels are either opaque or discarded, no blending
+	kTranslucent = 2, // Blended, drawn back to front after everything else
+};
+
+inline constexpr int kNumRenderTypes = 3;
+
+inline constexpr uint8_t kAir = 0;
+inline constexpr uint8_t kStone = 1;
+inline constexpr uint8_t kLamp = 2;
+inline constexpr uint8_t kGlass = 3;
+inline constexpr uint8_t kLeaves = 4;
+inline constexpr uint8_t kWater = 5;
+
+inline constexpr int kNumBlocks = 6;
+
+struct Info {
+	const char* name;
+	RenderType render_type;
+	bool solid; // Collides and stops rays
+	uint8_t emission; // Block light level
+	std::array<uint8_t, 6> tiles; // Atlas tile per side, in mesher order: left, right, bottom, top, back, front
+};
+
+inline constexpr std::array<Info, kNumBlocks> kInfos = { {
+	{ "air", kTranslucent, false, 0, { 0, 0, 0, 0, 0, 0 } },
+	{ "stone", kOpaque, true, 0, { 1, 1, 1, 1, 1, 1 } },
+	{ "lamp", kOpaque, true, 14, { 105, 105, 105, 105, 105, 105 } },
+	{ "glass", kCutout, true, 0, { 49, 49, 49, 49, 49, 49 } },
+	{ "leaves", kCutout, true, 0, { 52, 52, 52, 52, 52, 52 } },
+	{ "water", kTranslucent, false, 0, { 223, 223, 223, 223, 223, 223 } },
+} };
+
+// Unknown ids are treated as stone
+inline const Info& GetInfo(uint8_t id) {
+	return kInfos[id < kNumBlocks ? id : kStone];
+}
+
+// Indexed by any id without a bounds check, opacity is tested for every neighbour while meshing and lighting
+inline constexpr std::array<bool, 256> kOpaqueTable = []() {
+	std::array<bool, 256> table = {};
+	for (int id = 1; id < 256; ++id) {
+		table[id] = kInfos[id < kNumBlocks ? id : kStone].render_type == kOpaque;
+	}
+	return table;
+}();
+
+// Blocks light and hides the faces of its neighbours
+inline bool IsOpaque(uint8_t id) {
+	return kOpaqueTable[id];
+}
+
+inline bool IsSolid(uint8_t id) {
+	return GetInfo(id).solid;
+}
+
+// A face is hidden behind opaque blocks, and between two blocks of the same kind, like the inside of a lake
+inline bool IsFaceHidden(uint8_t id, uint8_t neighbor) {
+	return IsOpaque(neighbor) || neighbor == id;
+}
+
+} // namespace block
@@ -2,27 +2,150 @@
 
 #include <cstdint>
 #include <array>
-#include <glad/glad.h>
+#include <memory>
+#include <vector>
 #include <glm/glm.hpp>
+#include <src/utils/morton.h>
+#include <src/world/block.h>
 
-class Chunk {
+struct ChunkMesh {
+	uint64_t id; // Unique for every generated mesh
+	std::vector<float> vertices; // [x, y, z, u, v, ao, light, tile], four per quad
+	std::vector<uint32_t> indices; // Six per quad, quads are grouped by block::RenderType
+	std::array<uint32_t, block::kNumRenderTypes + 1> index_offsets = {}; // Start of each render type's indices, the last is the end
+
+	int GetNumIndices(block::RenderType type) const {
+		return (int)(index_offsets[type + 1] - index_offsets[type]);
+	}
+};
+
+// Order of the blocks in a chunk's arrays
+enum class ChunkLayout {
+	kLinear, // Rows along x, then layers along y, runs along x are contiguous
+	kMorton, // Z-order curve, only for cubes with a power of two size, neighbours along every axis stay close
+};
+
+// Chunk dimensions in blocks and their layout, fixed at compile time so all index math folds into constants
+template<int SizeX, int SizeY, int SizeZ, ChunkLayout Layout = ChunkLayout::kLinear>
+struct ChunkShape {
+	static_assert(Layout == ChunkLayout::kLinear || (SizeX == SizeY && SizeY == SizeZ && (SizeX & (SizeX - 1)) == 0 && SizeX <= 256),
+		"Morton layout needs a cube with a power of two size");
+
+	static inline constexpr int kSizeX = SizeX;
+	static inline constexpr int kSizeY = SizeY;
+	static inline constexpr int kSizeZ = SizeZ;
+	static inline constexpr int kVolume = SizeX * SizeY * SizeZ;
+	static inline constexpr ChunkLayout kLayout = Layout;
+
+	static constexpr int GetIndex(int x, int y, int z) {
+		if constexpr (Layout == ChunkLayout::kMorton) {
+			return (int)morton::Encode(x, y, z);
+		} else {
+			return x + SizeX * (y + SizeY * z);
+		}
+	}
+
+	// Coordinate of a block along an axis, 0 is x
+	static constexpr int GetCoord(int index, int axis) {
+		if constexpr (Layout == ChunkLayout::kMorton) {
+			return (int)morton::Decode(index, axis);
+		} else {
+			// A branch per axis, so every division is by a constant
+			switch (axis) {
+			case 0:
+				return index % SizeX;
+			case 1:
+				return index / SizeX % SizeY;
+			default:
+				return index / (SizeX * SizeY);
+			}
+		}
+	}
+
+	// Whether the neighbouring block along an axis, delta is +1 or -1, lies in the next chunk
+	static constexpr bool IsAtEdge(int index, int axis, int delta) {
+		if constexpr (Layout == ChunkLayout::kMorton) {
+			const int mask = (int)morton::kMasks[axis] & (kVolume - 1); // Testing the bits avoids decoding
+			return (index & mask) == (delta > 0 ? mask : 0);
+		} else {
+			constexpr int kSizes[] = { SizeX, SizeY, SizeZ };
+			return GetCoord(index, axis) == (delta > 0 ? kSizes[axis] - 1 : 0);
+		}
+	}
+
+	// Neighbouring block along an axis, delta is +1 or -1 and the result has to stay inside the chunk
+	static constexpr int Step(int index, int axis, int delta) {
+		if constexpr (Layout == ChunkLayout::kMorton) {
+			return (int)morton::Step(index, axis, delta);
+		} else {
+			constexpr int kStrides[] = { 1, SizeX, SizeX * SizeY };
+			return index + delta * kStrides[axis];
+		}
+	}
+
+	// Same block with its coordinate along an axis replaced, used to wrap around into the neighbouring chunk
+	static constexpr int SetCoord(int index, int axis, int coord) {
+		if constexpr (Layout == ChunkLayout::kMorton) {
+			return (int)((index & ~morton::kMasks[axis]) | (morton::kSpreadTable[coord] << axis));
+		} else {
+			constexpr int kStrides[] = { 1, SizeX, SizeX * SizeY };
+			return index + (coord - GetCoord(index, axis)) * kStrides[axis];
+		}
+	}
+};
+
+// Other shapes the mesher is compiled for, compared by chunk_size_benchmark and layout_benchmark
+using LinearChunkShape = ChunkShape<16, 16, 16>;
+using MortonChunkShape = ChunkShape<16, 16, 16, ChunkLayout::kMorton>;
+using LargeChunkShape = ChunkShape<32, 32, 32>;
+using ColumnChunkShape = ChunkShape<32, 256, 32>;
+
+// Blocks and light of a chunk of any shape
+template<typename Shape>
+class BasicChunk {
 public:
-	Chunk(glm::ivec3 index);
-	~Chunk();
+	BasicChunk(glm::ivec3 index) {
+		index_ = index;
+		data_.fill(0); // Filled in by terrain generation
+		light_.fill(0); // Filled in by lighting once loaded
+	}
+
+	uint8_t GetBlock(glm::ivec3 pos) const {
+		return data_[Shape::GetIndex(pos.x, pos.y, pos.z)];
+	}
 
-	void GenerateMesh();
+	void SetBlock(glm::ivec3 pos, uint8_t block) {
+		data_[Shape::GetIndex(pos.x, pos.y, pos.z)] = block;
+	}
 
-private:
-	int GetDataIndex(glm::ivec3 pos) const;
+	uint8_t GetLight(glm::ivec3 pos) const {
+		return light_[Shape::GetIndex(pos.x, pos.y, pos.z)];
+	}
 
 public:
-	static inline constexpr int kSize = 16;
-	static inline constexpr int kVolume = kSize * kSize * kSize;
+	static inline constexpr int kVolume = Shape::kVolume;
 
 	glm::ivec3 index_;
 	std::array<uint8_t, kVolume> data_;
+	std::array<uint8_t, kVolume> light_; // Sky light in the high nibble, block light in the low nibble
+	bool dirty_ = false; // Queued for remeshing
 
-	GLuint vao_, vbo_, ebo_;
-	unsigned int num_indices_ = 0;
+	std::shared_ptr<const ChunkMesh> mesh_; // Generated by the mesher
+
+};
+
+// Layout of the game's chunks, picked at build time with MINECRAFT_MORTON_CHUNKS
+#if defined(MORTON_CHUNKS)
+using GameChunkShape = MortonChunkShape;
+#else
+using GameChunkShape = LinearChunkShape;
+#endif
+
+// Chunks of the world, lighting and level of detail assume they are cubes of kSize
+class Chunk : public BasicChunk<GameChunkShape> {
+public:
+	using Shape = GameChunkShape;
+	static inline constexpr int kSize = Shape::kSizeX;
 
+	using BasicChunk::BasicChunk;
 };
@@ -1,9 +1,17 @@
 #include "chunk_manager.h"
 
+#include <algorithm>
+#include <chrono>
 #include <src/world/chunk.h>
+#include <src/world/terrain.h>
+#include <src/world/lighting.h>
+#include <src/world/mesher.h>
+#include <src/utils/profiler.h>
 
 ChunkManager::ChunkManager() {
 	center_ = glm::ivec3(1 << 30); // TODO: Remove
+	lighting_ = std::make_unique<Lighting>(this);
+	load_offsets_ = load_region_.GetOffsets();
 }
 
 ChunkManager::~ChunkManager() {
@@ -11,36 +19,277 @@ ChunkManager::~ChunkManager() {
 }
 
 void ChunkManager::Update(glm::vec3 pos) {
+	PROFILE_SCOPE("ChunkManager::Update");
+
 	glm::ivec3 new_center(glm::floor(pos / (float)Chunk::kSize));
-	if (center_ == new_center) {
-		return;
+	if (center_ != new_center) {
+		center_ = new_center;
+		QueueLoads();
+		QueueUnloads();
 	}
-	center_ = new_center;
-
-	glm::ivec3 min_bound = center_ - load_distance_;
-	glm::ivec3 max_bound = center_ + load_distance_;
-	glm::ivec3 i;
-	for (i.x = min_bound.x; i.x <= max_bound.x; ++i.x) {
-		for (i.y = min_bound.y; i.y <= max_bound.y; ++i.y) {
-			for (i.z = min_bound.z; i.z <= max_bound.z; ++i.z) {
-				const auto& it = chunks_.find(i);
-				if (it != chunks_.end()) {
-					continue;
-				}
-				chunks_.emplace(i, new Chunk(i));
+
+	// Work is time-sliced, whatever doesn't fit into the budget is resumed on the next call
+	const auto time_start = std::chrono::steady_clock::now();
+	auto out_of_time = [&]() {
+		if (budget_.max_time_us <= 0.0f) {
+			return false;
+		}
+		float elapsed_us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - time_start).count();
+		return elapsed_us >= budget_.max_time_us;
+	};
+
+	// Edits are not limited by the budget, since they are directly visible to the player
+	for (const auto& [index, edit_time] : edited_chunks_) {
+		Chunk* chunk = GetChunk(index);
+		if (!chunk) {
+			continue;
+		}
+		RemeshChunk(chunk);
+
+		float latency_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - edit_time).count();
+		++edit_stats_.remeshes;
+		edit_stats_.total_latency_ms += latency_ms;
+		edit_stats_.max_latency_ms = std::max(edit_stats_.max_latency_ms, latency_ms);
+	}
+	edited_chunks_.clear();
+
+	// Unload
+	int num_unloads = 0;
+	while (!unload_queue_.empty() && num_unloads < budget_.max_unloads && !out_of_time()) {
+		glm::ivec3 index = unload_queue_.back();
+		unload_queue_.pop_back();
+
+		// Check against the current center, since it might have moved since the chunk was queued
+		if (!load_region_.Contains(index - center_, unload_offset_)) {
+			if (chunks_.erase(index) > 0) {
+				++num_unloads;
+				++counters_.unloads;
 			}
 		}
 	}
 
-	for (auto it = chunks_.begin(); it != chunks_.end();) {
-		int unload_distance = load_distance_ + unload_offset_;
-		bool should_delete = glm::any(glm::greaterThan(glm::abs(it->first - center_), glm::ivec3(unload_distance)));
-		if (!should_delete) {
-			++it;
+	// Load
+	int num_loads = 0;
+	while (!load_queue_.empty() && num_loads < budget_.max_loads && !out_of_time()) {
+		glm::ivec3 index = load_queue_.back();
+		load_queue_.pop_back();
+
+		if (!IsInLoadRegion(index)) {
+			continue;
+		}
+		if (chunks_.find(index) != chunks_.end()) {
 			continue;
 		}
-		it = chunks_.erase(it);
+		Chunk* chunk = new Chunk(index);
+		terrain::GenerateChunk(chunk);
+		chunks_.emplace(index, chunk);
+		lighting_->InitChunk(chunk);
+		QueueRemesh(chunk);
+		// Meshed neighbours culled their faces and baked ambient occlusion against the missing chunk
+		glm::ivec3 offset;
+		for (offset.z = -1; offset.z <= 1; ++offset.z) {
+			for (offset.y = -1; offset.y <= 1; ++offset.y) {
+				for (offset.x = -1; offset.x <= 1; ++offset.x) {
+					Chunk* neighbor = GetChunk(index + offset);
+					if (neighbor && neighbor->mesh_) {
+						QueueRemesh(neighbor);
+					}
+				}
+			}
+		}
+		for (const glm::ivec3& touched : lighting_->GetTouched()) {
+			if (Chunk* neighbor = GetChunk(touched)) {
+				QueueRemesh(neighbor); // Light spread into an already meshed chunk
+			}
+		}
+		++num_loads;
+		++counters_.loads;
+	}
+
+	// Remesh
+	int num_remeshes = 0;
+	while (remesh_queue_head_ < remesh_queue_.size() && num_remeshes < budget_.max_remeshes && !out_of_time()) {
+		Chunk* chunk = GetChunk(remesh_queue_[remesh_queue_head_++]);
+		if (!chunk || !chunk->dirty_) {
+			continue; // Unloaded or remeshed in the meantime
+		}
+		RemeshChunk(chunk);
+		++num_remeshes;
+	}
+	if (remesh_queue_head_ == remesh_queue_.size()) {
+		remesh_queue_.clear();
+		remesh_queue_head_ = 0;
+	}
+}
+
+void ChunkManager::QueueLoads() {
+	// The offsets are already sorted, walking them backwards queues the farthest chunks first
+	load_queue_.clear();
+	for (auto it = load_offsets_.rbegin(); it != load_offsets_.rend(); ++it) {
+		glm::ivec3 index = center_ + *it;
+		if (chunks_.find(index) == chunks_.end()) {
+			load_queue_.push_back(index);
+		}
+	}
+}
+
+void ChunkManager::QueueUnloads() {
+	unload_queue_.clear();
+	unload_queue_.reserve(chunks_.size());
+	for (const auto& [index, _] : chunks_) {
+		unload_queue_.push_back(index);
+	}
+}
+
+void ChunkManager::QueueRemesh(Chunk* chunk) {
+	if (chunk->dirty_) {
+		return; // Already queued
+	}
+	chunk->dirty_ = true;
+	remesh_queue_.push_back(chunk->index_);
+}
+
+void ChunkManager::MarkEdited(glm::ivec3 index, std::chrono::steady_clock::time_point time) {
+	if (GetChunk(index)) {
+		edited_chunks_.emplace(index, time); // Keeps the time of the first edit
+	}
+}
+
+void ChunkManager::RemeshChunk(Chunk* chunk) {
+	mesher::Neighborhood neighbors;
+	glm::ivec3 offset;
+	for (offset.z = -1; offset.z <= 1; ++offset.z) {
+		for (offset.y = -1; offset.y <= 1; ++offset.y) {
+			for (offset.x = -1; offset.x <= 1; ++offset.x) {
+				neighbors[mesher::GetNeighborIndex(offset)] = GetChunk(chunk->index_ + offset);
+			}
+		}
+	}
+	mesher::Input input;
+	mesher::Gather(neighbors, &input);
+	chunk->mesh_ = mesher::GenerateMesh(input);
+	chunk->dirty_ = false;
+	++counters_.meshes;
+}
+
+uint8_t ChunkManager::GetBlock(glm::ivec3 pos) const {
+	glm::ivec3 index = GetChunkIndex(pos);
+	Chunk* chunk = GetChunk(index);
+	if (!chunk) {
+		return 0;
+	}
+	return chunk->GetBlock(pos - index * Chunk::kSize);
+}
+
+bool ChunkManager::SetBlock(glm::ivec3 pos, uint8_t block) {
+	glm::ivec3 index = GetChunkIndex(pos);
+	Chunk* chunk = GetChunk(index);
+	if (!chunk) {
+		return false;
+	}
+	glm::ivec3 local_pos = pos - index * Chunk::kSize;
+	if (chunk->GetBlock(local_pos) == block) {
+		return true;
+	}
+	chunk->SetBlock(local_pos, block);
+	lighting_->UpdateBlock(pos);
+	++edit_stats_.edits;
+
+	// Neighbouring meshes read this chunk's border for face culling and ambient occlusion,
+	// so every chunk whose mesher border contains the block is rebuilt too (up to 8 at a corner)
+	const auto now = std::chrono::steady_clock::now();
+	glm::ivec3 min_offset(0), max_offset(0);
+	for (int dim = 0; dim < 3; ++dim) {
+		if (local_pos[dim] == 0) {
+			min_offset[dim] = -1;
+		} else if (local_pos[dim] == Chunk::kSize - 1) {
+			max_offset[dim] = 1;
+		}
+	}
+	glm::ivec3 offset;
+	for (offset.z = min_offset.z; offset.z <= max_offset.z; ++offset.z) {
+		for (offset.y = min_offset.y; offset.y <= max_offset.y; ++offset.y) {
+			for (offset.x = min_offset.x; offset.x <= max_offset.x; ++offset.x) {
+				MarkEdited(index + offset, now);
+			}
+		}
+	}
+	for (const glm::ivec3& touched : lighting_->GetTouched()) {
+		MarkEdited(touched, now);
+	}
+	return true;
+}
+
+uint8_t ChunkManager::GetLight(glm::ivec3 pos) const {
+	glm::ivec3 index = GetChunkIndex(pos);
+	Chunk* chunk = GetChunk(index);
+	if (!chunk) {
+		return light::Pack(light::kMaxLevel, 0);
 	}
+	return chunk->GetLight(pos - index * Chunk::kSize);
+}
+
+const ChunkManager::EditStats& ChunkManager::GetEditStats() const {
+	return edit_stats_;
+}
+
+void ChunkManager::ResetEditStats() {
+	edit_stats_ = EditStats();
+}
+
+glm::ivec3 ChunkManager::GetChunkIndex(glm::ivec3 pos) {
+	// Integer division that rounds towards negative infinity
+	glm::ivec3 index;
+	for (int i = 0; i < 3; ++i) {
+		index[i] = (pos[i] >= 0 ? pos[i] : pos[i] - (Chunk::kSize - 1)) / Chunk::kSize;
+	}
+	return index;
+}
+
+void ChunkManager::SetBudget(const Budget& budget) {
+	budget_ = budget;
+}
+
+const ChunkManager::Budget& ChunkManager::GetBudget() const {
+	return budget_;
+}
+
+ChunkManager::Backlog ChunkManager::GetBacklog() const {
+	Backlog backlog;
+	backlog.loads = (int)load_queue_.size();
+	backlog.unloads = (int)unload_queue_.size();
+	backlog.remeshes = (int)(remesh_queue_.size() - remesh_queue_head_);
+	return backlog;
+}
+
+const ChunkManager::Counters& ChunkManager::GetCounters() const {
+	return counters_;
+}
+
+void ChunkManager::SetLoadRegion(const LoadRegion& region) {
+	if (region == load_region_) {
+		return;
+	}
+	load_region_ = region;
+	load_offsets_ = load_region_.GetOffsets();
+	QueueLoads();
+	QueueUnloads();
+}
+
+const LoadRegion& ChunkManager::GetLoadRegion() const {
+	return load_region_;
+}
+
+glm::ivec3 ChunkManager::GetCenter() const {
+	return center_;
+}
+
+bool ChunkManager::IsInLoadRegion(glm::ivec3 index) const {
+	return load_region_.Contains(index - center_);
+}
+
+const Lighting& ChunkManager::GetLighting() const {
+	return *lighting_;
 }
 
 Chunk* ChunkManager::GetChunk(glm::ivec3 index) const {
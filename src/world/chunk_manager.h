@@ -1,11 +1,17 @@
 #pragma once
 
+#include <cstdint>
+#include <array>
+#include <chrono>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 #include <glm/glm.hpp>
 #include <src/utils/hash.h>
+#include <src/world/load_region.h>
 
 class Chunk;
+class Lighting;
 
 // TODO: Think of a better name
 class ChunkManager {
@@ -13,18 +19,93 @@ class ChunkManager {
 	using ChunkMap = std::unordered_map<glm::ivec3, std::unique_ptr<Chunk>, hash::Hash<glm::ivec3>>;
 
 public:
+	// Maximum amount of work done per call to Update, the rest is deferred to later frames
+	struct Budget {
+		int max_loads = 8;
+		int max_unloads = 16;
+		int max_remeshes = 4;
+		float max_time_us = 2000.0f; // Zero or less disables the time limit
+	};
+
+	// Amount of work that is still queued
+	struct Backlog {
+		int loads = 0;
+		int unloads = 0;
+		int remeshes = 0;
+	};
+
+	// Accumulated since the last call to ResetEditStats
+	struct EditStats {
+		int edits = 0;
+		int remeshes = 0;
+		float total_latency_ms = 0.0f; // Time from the first edit of a chunk until it was remeshed
+		float max_latency_ms = 0.0f;
+	};
+
+	// Total amount of work done since creation
+	struct Counters {
+		uint64_t loads = 0;
+		uint64_t unloads = 0;
+		uint64_t meshes = 0;
+	};
+
 	ChunkManager();
 	~ChunkManager();
 
 	void Update(glm::vec3 pos);
 
+	void SetBudget(const Budget& budget);
+	const Budget& GetBudget() const;
+	Backlog GetBacklog() const;
+	const Counters& GetCounters() const;
+	// Chunks at these offsets from the center are loaded, the ones past the unload margin are unloaded
+	void SetLoadRegion(const LoadRegion& region);
+	const LoadRegion& GetLoadRegion() const;
+	// Index of the chunk the last position passed to Update was in
+	glm::ivec3 GetCenter() const;
+	// Whether a chunk is inside the load region, loaded chunks outside of it are only kept for hysteresis
+	bool IsInLoadRegion(glm::ivec3 index) const;
+
+	// Blocks are addressed in world coordinates, unloaded blocks are treated as air
+	uint8_t GetBlock(glm::ivec3 pos) const;
+	bool SetBlock(glm::ivec3 pos, uint8_t block);
+	// Packed sky and block light, unloaded blocks are treated as open sky
+	uint8_t GetLight(glm::ivec3 pos) const;
+
+	const EditStats& GetEditStats() const;
+	void ResetEditStats();
+
+	const Lighting& GetLighting() const;
+
 	Chunk* GetChunk(glm::ivec3 index) const;
 	const ChunkMap& GetChunks() const;
 
+	static glm::ivec3 GetChunkIndex(glm::ivec3 pos);
+
+private:
+	void QueueLoads();
+	void QueueUnloads();
+	void QueueRemesh(Chunk* chunk);
+	void MarkEdited(glm::ivec3 index, std::chrono::steady_clock::time_point time);
+	void RemeshChunk(Chunk* chunk);
+
 private:
 	ChunkMap chunks_;
 	glm::ivec3 center_;
+	std::unique_ptr<Lighting> lighting_;
 
-	int load_distance_ = 4;
+	LoadRegion load_region_;
+	std::vector<glm::ivec3> load_offsets_; // Offsets inside load_region_, sorted from nearest to farthest
 	int unload_offset_ = 2;
+
+	Budget budget_;
+	std::vector<glm::ivec3> load_queue_; // Sorted from farthest to nearest, so nearest chunks are popped first
+	std::vector<glm::ivec3> unload_queue_; // Chunks that still have to be checked against the unload distance
+	std::vector<glm::ivec3> remesh_queue_;
+	size_t remesh_queue_head_ = 0;
+
+	// Edited chunks are remeshed once per frame, before the budgeted queues
+	std::unordered_map<glm::ivec3, std::chrono::steady_clock::time_point, hash::Hash<glm::ivec3>> edited_chunks_;
+	EditStats edit_stats_;
+	Counters counters_;
 };
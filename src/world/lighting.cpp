@@ -0,0 +1,314 @@
+#include "lighting.h"
+
+#include <array>
+#include <src/world/block.h>
+#include <src/world/chunk.h>
+#include <src/world/chunk_manager.h>
+#include <src/utils/profiler.h>
+
+namespace {
+
+constexpr int n = Chunk::kSize;
+
+// Same order as the mesher sides
+const glm::ivec3 kSideDirections[] = {
+	{ -1, 0, 0 }, { +1, 0, 0 }, { 0, -1, 0 }, { 0, +1, 0 }, { 0, 0, -1 }, { 0, 0, +1 }
+};
+constexpr int kDown = 2;
+
+// Index math goes through the chunk shape, so lighting works with either layout
+using Shape = Chunk::Shape;
+
+glm::ivec3 GetLocalPos(int index) {
+	return { Shape::GetCoord(index, 0), Shape::GetCoord(index, 1), Shape::GetCoord(index, 2) };
+}
+
+int GetIndex(glm::ivec3 pos) {
+	return Shape::GetIndex(pos.x, pos.y, pos.z);
+}
+
+} // namespace
+
+Lighting::Lighting(const ChunkManager* chunk_manager) {
+	chunk_manager_ = chunk_manager;
+}
+
+void Lighting::InitChunk(Chunk* chunk) {
+	PROFILE_SCOPE("Lighting::InitChunk");
+
+	BeginTouched();
+	++stats_.chunks;
+
+	const Chunk* above = chunk_manager_->GetChunk(chunk->index_ + glm::ivec3(0, 1, 0));
+	Chunk* below = chunk_manager_->GetChunk(chunk->index_ - glm::ivec3(0, 1, 0));
+
+	// Column heightmap, the highest opaque block or -1
+	// Columns are open to the sky unless the chunk above has shadowed them, an unloaded chunk above counts as sky
+	std::array<int, n * n> heights;
+	std::array<bool, n * n> open;
+	chunk->light_.fill(0);
+	for (int z = 0; z < n; ++z) {
+		for (int x = 0; x < n; ++x) {
+			int height = n - 1;
+			while (height >= 0 && !block::IsOpaque(chunk->data_[GetIndex({ x, height, z })])) {
+				--height;
+			}
+			heights[x + n * z] = height;
+			open[x + n * z] = !above || light::GetSky(above->light_[GetIndex({ x, 0, z })]) == light::kMaxLevel;
+			if (open[x + n * z]) {
+				for (int y = height + 1; y < n; ++y) {
+					chunk->light_[GetIndex({ x, y, z })] = light::Pack(light::kMaxLevel, 0);
+				}
+			}
+		}
+	}
+
+	// Columns of the chunk below were lit as if this chunk was sky
+	if (below) {
+		for (int z = 0; z < n; ++z) {
+			for (int x = 0; x < n; ++x) {
+				Node node = { below, GetIndex({ x, n - 1, z }) };
+				if (GetLevel(node, kSky) == light::kMaxLevel && !(open[x + n * z] && heights[x + n * z] < 0)) {
+					SetLevel(node, kSky, 0);
+					removal_queue_.push_back({ node, light::kMaxLevel });
+				}
+			}
+		}
+		PropagateRemovals(kSky);
+	}
+
+	// Sky light spreads sideways from lit columns under the overhangs of taller neighbouring columns
+	for (int z = 0; z < n; ++z) {
+		for (int x = 0; x < n; ++x) {
+			if (!open[x + n * z]) {
+				continue;
+			}
+			int max_height = heights[x + n * z];
+			for (int side : { 0, 1, 4, 5 }) {
+				glm::ivec3 pos = glm::ivec3(x, 0, z) + kSideDirections[side];
+				if (pos.x >= 0 && pos.x < n && pos.z >= 0 && pos.z < n) {
+					max_height = std::max(max_height, heights[pos.x + n * pos.z]);
+				}
+			}
+			for (int y = heights[x + n * z] + 1; y <= max_height; ++y) {
+				queue_.push_back({ chunk, GetIndex({ x, y, z }) });
+			}
+		}
+	}
+
+	for (int i = 0; i < Chunk::kVolume; ++i) {
+		if (uint8_t emission = block::GetInfo(chunk->data_[i]).emission) {
+			chunk->light_[i] = light::Pack(light::GetSky(chunk->light_[i]), emission);
+		}
+	}
+
+	for (Channel channel : { kSky, kBlock }) {
+		// Light flows across the faces shared with loaded neighbours, in both directions
+		// Only blocks that brighten the other side are queued, so uniformly lit faces cost no propagation
+		auto brightens = [&](const Node& from, const Node& to, bool down) {
+			if (block::IsOpaque(to.chunk->data_[to.index])) {
+				return false;
+			}
+			int level = GetLevel(from, channel);
+			int next_level = channel == kSky && down && level == light::kMaxLevel ? level : level - 1;
+			return GetLevel(to, channel) < next_level;
+		};
+		for (int side = 0; side < 6; ++side) {
+			Chunk* neighbor = chunk_manager_->GetChunk(chunk->index_ + kSideDirections[side]);
+			if (!neighbor) {
+				continue;
+			}
+			const int dim = side / 2;
+			glm::ivec3 inner, outer;
+			inner[dim] = side % 2 == 0 ? 0 : n - 1;
+			outer[dim] = n - 1 - inner[dim];
+			for (int a = 0; a < n; ++a) {
+				for (int b = 0; b < n; ++b) {
+					inner[(dim + 1) % 3] = outer[(dim + 1) % 3] = a;
+					inner[(dim + 2) % 3] = outer[(dim + 2) % 3] = b;
+					Node inner_node = { chunk, GetIndex(inner) };
+					Node outer_node = { neighbor, GetIndex(outer) };
+					if (brightens(inner_node, outer_node, side == kDown)) {
+						queue_.push_back(inner_node);
+					}
+					if (brightens(outer_node, inner_node, side == kDown + 1)) {
+						queue_.push_back(outer_node);
+					}
+				}
+			}
+		}
+
+		if (channel == kBlock) {
+			for (int i = 0; i < Chunk::kVolume; ++i) {
+				if (light::GetBlock(chunk->light_[i]) > 1) {
+					queue_.push_back({ chunk, i });
+				}
+			}
+		}
+		Propagate(channel);
+	}
+	EndTouched();
+}
+
+void Lighting::UpdateBlock(glm::ivec3 pos) {
+	PROFILE_SCOPE("Lighting::UpdateBlock");
+
+	BeginTouched();
+	++stats_.updates;
+
+	Node node = GetNode(pos);
+	if (!node.chunk) {
+		EndTouched();
+		return;
+	}
+	const uint8_t id = node.chunk->data_[node.index];
+
+	for (Channel channel : { kSky, kBlock }) {
+		// Whatever was lit through this block goes dark first, then refills from the remaining sources
+		uint8_t level = GetLevel(node, channel);
+		if (level > 0 && (block::IsOpaque(id) || channel == kBlock)) {
+			SetLevel(node, channel, 0);
+			removal_queue_.push_back({ node, level });
+		}
+
+		if (!block::IsOpaque(id)) {
+			for (int side = 0; side < 6; ++side) {
+				Node neighbor = GetNeighbor(node, side);
+				if (neighbor.chunk && GetLevel(neighbor, channel) > 0) {
+					queue_.push_back(neighbor);
+				}
+			}
+		} else if (channel == kBlock && block::GetInfo(id).emission > 0) {
+			SetLevel(node, channel, block::GetInfo(id).emission);
+			queue_.push_back(node);
+		}
+
+		PropagateRemovals(channel);
+		Propagate(channel);
+	}
+	EndTouched();
+}
+
+void Lighting::BeginTouched() {
+	touched_chunks_.clear();
+	touched_.clear();
+}
+
+void Lighting::EndTouched() {
+	for (const TouchedChunk& touched : touched_chunks_) {
+		for (int i = 0; i < 27; ++i) {
+			if (touched.neighbors & (1u << i)) {
+				touched_.insert(touched.chunk->index_ + glm::ivec3(i % 3 - 1, i / 3 % 3 - 1, i / 9 - 1));
+			}
+		}
+	}
+}
+
+const Lighting::IndexSet& Lighting::GetTouched() const {
+	return touched_;
+}
+
+const Lighting::Stats& Lighting::GetStats() const {
+	return stats_;
+}
+
+Lighting::Node Lighting::GetNode(glm::ivec3 pos) const {
+	glm::ivec3 index = ChunkManager::GetChunkIndex(pos);
+	return { chunk_manager_->GetChunk(index), GetIndex(pos - index * n) };
+}
+
+Lighting::Node Lighting::GetNeighbor(const Node& node, int side) const {
+	// Only the coordinate along the side's axis matters, so the index is stepped directly
+	const int axis = side / 2;
+	const int delta = side % 2 == 0 ? -1 : +1;
+	if (!Shape::IsAtEdge(node.index, axis, delta)) {
+		return { node.chunk, Shape::Step(node.index, axis, delta) };
+	}
+	return { chunk_manager_->GetChunk(node.chunk->index_ + kSideDirections[side]), Shape::SetCoord(node.index, axis, delta > 0 ? 0 : n - 1) };
+}
+
+uint8_t Lighting::GetLevel(const Node& node, Channel channel) const {
+	return (node.chunk->light_[node.index] >> channel) & 0xF;
+}
+
+void Lighting::SetLevel(const Node& node, Channel channel, uint8_t level) {
+	uint8_t& light = node.chunk->light_[node.index];
+	light = (uint8_t)((light & ~(0xF << channel)) | (level << channel));
+	++stats_.changed;
+
+	// Meshes of neighbouring chunks read the light of this chunk's border
+	glm::ivec3 pos = GetLocalPos(node.index);
+	glm::ivec3 min_offset(0), max_offset(0);
+	for (int dim = 0; dim < 3; ++dim) {
+		if (pos[dim] == 0) {
+			min_offset[dim] = -1;
+		} else if (pos[dim] == n - 1) {
+			max_offset[dim] = 1;
+		}
+	}
+	uint32_t neighbors = 0;
+	glm::ivec3 offset;
+	for (offset.z = min_offset.z; offset.z <= max_offset.z; ++offset.z) {
+		for (offset.y = min_offset.y; offset.y <= max_offset.y; ++offset.y) {
+			for (offset.x = min_offset.x; offset.x <= max_offset.x; ++offset.x) {
+				neighbors |= 1u << ((offset.x + 1) + 3 * ((offset.y + 1) + 3 * (offset.z + 1)));
+			}
+		}
+	}
+	for (TouchedChunk& touched : touched_chunks_) {
+		if (touched.chunk == node.chunk) {
+			touched.neighbors |= neighbors;
+			return;
+		}
+	}
+	touched_chunks_.push_back({ node.chunk, neighbors });
+}
+
+void Lighting::PropagateRemovals(Channel channel) {
+	while (removal_queue_head_ < removal_queue_.size()) {
+		RemovalNode removal = removal_queue_[removal_queue_head_++];
+		for (int side = 0; side < 6; ++side) {
+			Node neighbor = GetNeighbor(removal.node, side);
+			if (!neighbor.chunk) {
+				continue;
+			}
+			uint8_t level = GetLevel(neighbor, channel);
+			if (level == 0) {
+				continue;
+			}
+			// Full sky light falls straight down without losing a level, so it depends on the block above
+			bool lit_by_removed = level < removal.level || (channel == kSky && side == kDown && removal.level == light::kMaxLevel);
+			if (lit_by_removed && !(channel == kBlock && block::GetInfo(neighbor.chunk->data_[neighbor.index]).emission > 0)) {
+				SetLevel(neighbor, channel, 0);
+				removal_queue_.push_back({ neighbor, level });
+			} else {
+				queue_.push_back(neighbor); // Lit by another source, spreads back into the darkened blocks
+			}
+		}
+	}
+	removal_queue_.clear();
+	removal_queue_head_ = 0;
+}
+
+void Lighting::Propagate(Channel channel) {
+	while (queue_head_ < queue_.size()) {
+		Node node = queue_[queue_head_++];
+		uint8_t level = GetLevel(node, channel);
+		if (level <= 1) {
+			continue;
+		}
+		for (int side = 0; side < 6; ++side) {
+			Node neighbor = GetNeighbor(node, side);
+			if (!neighbor.chunk || block::IsOpaque(neighbor.chunk->data_[neighbor.index])) {
+				continue; // Unloaded or opaque
+			}
+			uint8_t next_level = channel == kSky && side == kDown && level == light::kMaxLevel ? level : level - 1;
+			if (GetLevel(neighbor, channel) < next_level) {
+				SetLevel(neighbor, channel, next_level);
+				queue_.push_back(neighbor);
+			}
+		}
+	}
+	queue_.clear();
+	queue_head_ = 0;
+}
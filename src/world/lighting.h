@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include <glm/glm.hpp>
+#include <src/utils/hash.h>
+
+class Chunk;
+class ChunkManager;
+
+// Light levels are stored per block, sky light in the high nibble and block light in the low nibble
+namespace light {
+
+inline constexpr uint8_t kMaxLevel = 15;
+
+inline uint8_t GetSky(uint8_t light) {
+	return light >> 4;
+}
+
+inline uint8_t GetBlock(uint8_t light) {
+	return light & 0xF;
+}
+
+inline uint8_t Pack(uint8_t sky, uint8_t block) {
+	return (uint8_t)((sky << 4) | block);
+}
+
+} // namespace light
+
+// Flood fills sky and block light across loaded chunks
+// Edits only revisit the blocks whose light depended on the edited one
+// - https://www.seedofandromeda.com/blogs/29-fast-flood-fill-lighting-in-a-blocky-voxel-game-pt-1
+// - https://www.seedofandromeda.com/blogs/30-fast-flood-fill-lighting-in-a-blocky-voxel-game-pt-2
+class Lighting {
+
+	using IndexSet = std::unordered_set<glm::ivec3, hash::Hash<glm::ivec3>>;
+
+public:
+	// Accumulated since creation
+	struct Stats {
+		uint64_t chunks = 0; // Initialized on load
+		uint64_t updates = 0; // Block edits
+		uint64_t changed = 0; // Light values written
+	};
+
+	Lighting(const ChunkManager* chunk_manager);
+
+	// Lights a freshly generated chunk and spreads light between it and its loaded neighbours
+	void InitChunk(Chunk* chunk);
+	// Should be called after the block at pos has changed
+	void UpdateBlock(glm::ivec3 pos);
+
+	// Chunks whose meshes read light changed by the last call, including neighbours that see it through their border
+	const IndexSet& GetTouched() const;
+	const Stats& GetStats() const;
+
+private:
+	enum Channel {
+		kSky = 4, // Shift of the nibble
+		kBlock = 0
+	};
+
+	struct Node {
+		Chunk* chunk;
+		int index; // Into chunk data
+	};
+
+	struct RemovalNode {
+		Node node;
+		uint8_t level; // Before removal
+	};
+
+	struct TouchedChunk {
+		Chunk* chunk;
+		uint32_t neighbors; // Bit per 3x3x3 neighbour offset, (x + 1) + 3 * ((y + 1) + 3 * (z + 1))
+	};
+
+	Node GetNode(glm::ivec3 pos) const;
+	Node GetNeighbor(const Node& node, int side) const;
+	uint8_t GetLevel(const Node& node, Channel channel) const;
+	void SetLevel(const Node& node, Channel channel, uint8_t level);
+
+	void PropagateRemovals(Channel channel);
+	void Propagate(Channel channel);
+	void BeginTouched();
+	void EndTouched();
+
+private:
+	const ChunkManager* chunk_manager_;
+
+	// FIFO queues, kept between calls so updates don't allocate once they have grown
+	std::vector<Node> queue_;
+	size_t queue_head_ = 0;
+	std::vector<RemovalNode> removal_queue_;
+	size_t removal_queue_head_ = 0;
+
+	// Collected per chunk during a call, since light writes are far more frequent than touched chunks
+	std::vector<TouchedChunk> touched_chunks_;
+	IndexSet touched_;
+	Stats stats_;
+};
@@ -0,0 +1,49 @@
+#include "load_region.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+bool LoadRegion::Contains(glm::ivec3 offset, int margin) const {
+	// Round shapes compare against r * (r + 1), roughly (r + 0.5)^2, so the cells at the tips of the axes aren't left on their own
+	const int r = radius + margin;
+	switch (shape) {
+	case kCube:
+		return glm::all(glm::lessThanEqual(glm::abs(offset), glm::ivec3(r)));
+	case kCylinder:
+		return offset.x * offset.x + offset.z * offset.z <= r * (r + 1) && std::abs(offset.y) <= height + margin;
+	case kSphere:
+		return offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= r * (r + 1);
+	}
+	return false;
+}
+
+std::vector<glm::ivec3> LoadRegion::GetOffsets() const {
+	std::vector<glm::ivec3> offsets;
+	const int extent = std::max(radius, shape == kCylinder ? height : 0);
+	glm::ivec3 i;
+	for (i.x = -extent; i.x <= extent; ++i.x) {
+		for (i.y = -extent; i.y <= extent; ++i.y) {
+			for (i.z = -extent; i.z <= extent; ++i.z) {
+				if (Contains(i)) {
+					offsets.push_back(i);
+				}
+			}
+		}
+	}
+
+	auto distance2 = [](const glm::ivec3& d) {
+		return d.x * d.x + d.y * d.y + d.z * d.z;
+	};
+	std::stable_sort(offsets.begin(), offsets.end(), [&](const glm::ivec3& lhs, const glm::ivec3& rhs) {
+		return distance2(lhs) < distance2(rhs);
+	});
+	return offsets;
+}
+
+bool LoadRegion::operator==(const LoadRegion& other) const {
+	return shape == other.shape && radius == other.radius && height == other.height;
+}
+
+bool LoadRegion::operator!=(const LoadRegion& other) const {
+	return !(*this == other);
+}
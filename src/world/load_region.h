@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Shape of the region kept loaded around the player, in cells (chunks or tiles) relative to the cell the player is in
+struct LoadRegion {
+	// Values are shared with lod.frag
+	enum Shape {
+		kCube = 0,
+		kCylinder = 1, // Circle in the horizontal plane, with its own vertical distance
+		kSphere = 2,
+	};
+
+	Shape shape = kCylinder;
+	int radius = 4;
+	int height = 2; // Cells above and below the center, only used by the cylinder
+
+	// The margin grows the region on all sides, used for unload hysteresis
+	bool Contains(glm::ivec3 offset, int margin = 0) const;
+	// Every offset inside the region, sorted from nearest to farthest
+	std::vector<glm::ivec3> GetOffsets() const;
+
+	bool operator==(const LoadRegion& other) const;
+	bool operator!=(const LoadRegion& other) const;
+};
@@ -0,0 +1,185 @@
+#include "lod.h"
+
+#include <algorithm>
+#include <chrono>
+#include <src/world/chunk.h>
+#include <src/world/mesher.h>
+#include <src/world/terrain.h>
+#include <src/world/lighting.h>
+#include <src/utils/profiler.h>
+
+LodManager::LodManager() {
+	offsets_ = region_.GetOffsets();
+}
+
+LodManager::~LodManager() {
+
+}
+
+void LodManager::Update(glm::vec3 pos, const LoadRegion& inner_region, glm::ivec3 inner_center) {
+	PROFILE_SCOPE("LodManager::Update");
+
+	// Each level is recentered on its own tile grid and skips what the level below covers
+	const LoadRegion* inner = &inner_region;
+	for (int level = 1; level <= kNumLevels; ++level) {
+		Level& data = levels_[level - 1];
+		glm::ivec3 center(glm::floor(pos / (float)GetTileSize(level)));
+		if (center != data.center || inner_center != data.inner_center || *inner != data.inner_region) {
+			data.center = center;
+			data.inner_center = inner_center;
+			data.inner_region = *inner;
+			QueueTiles(level);
+		}
+		inner_center = data.center;
+		inner = &region_;
+	}
+
+	const auto time_start = std::chrono::steady_clock::now();
+	auto out_of_time = [&]() {
+		if (budget_.max_time_us <= 0.0f) {
+			return false;
+		}
+		float elapsed_us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - time_start).count();
+		return elapsed_us >= budget_.max_time_us;
+	};
+
+	// Finer levels first, they are closer to the player
+	int num_meshes = 0;
+	mesher::Input input;
+	for (int level = 1; level <= kNumLevels; ++level) {
+		Level& data = levels_[level - 1];
+		while (!data.queue.empty() && num_meshes < budget_.max_meshes && !out_of_time()) {
+			glm::ivec3 index = data.queue.back();
+			data.queue.pop_back();
+			if (data.tiles.find(index) != data.tiles.end()) {
+				continue;
+			}
+			GenerateInput(level, index, &input);
+			data.tiles.emplace(index, mesher::GenerateMesh(input));
+			++num_meshes;
+		}
+	}
+}
+
+void LodManager::QueueTiles(int level) {
+	Level& data = levels_[level - 1];
+
+	// Unload tiles past the hysteresis margin, or hidden by the level below
+	for (auto it = data.tiles.begin(); it != data.tiles.end();) {
+		if (!region_.Contains(it->first - data.center, unload_offset_) || IsHidden(level, it->first)) {
+			it = data.tiles.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// Walking the sorted offsets backwards queues the farthest tiles first
+	data.queue.clear();
+	for (auto it = offsets_.rbegin(); it != offsets_.rend(); ++it) {
+		glm::ivec3 index = data.center + *it;
+		if (data.tiles.find(index) == data.tiles.end() && !IsHidden(level, index)) {
+			data.queue.push_back(index);
+		}
+	}
+}
+
+bool LodManager::IsHidden(int level, glm::ivec3 index) const {
+	// A tile covers 2x2x2 tiles of the level below, it's hidden when all of them are inside that level's region
+	const Level& data = levels_[level - 1];
+	glm::ivec3 offset;
+	for (offset.z = 0; offset.z < 2; ++offset.z) {
+		for (offset.y = 0; offset.y < 2; ++offset.y) {
+			for (offset.x = 0; offset.x < 2; ++offset.x) {
+				if (!data.inner_region.Contains(index * 2 + offset - data.inner_center)) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+void LodManager::SetBudget(const Budget& budget) {
+	budget_ = budget;
+}
+
+const LodManager::Budget& LodManager::GetBudget() const {
+	return budget_;
+}
+
+int LodManager::GetBacklog() const {
+	int backlog = 0;
+	for (const Level& data : levels_) {
+		backlog += (int)data.queue.size();
+	}
+	return backlog;
+}
+
+void LodManager::SetRegion(const LoadRegion& region) {
+	if (region == region_) {
+		return;
+	}
+	region_ = region;
+	offsets_ = region_.GetOffsets();
+	for (Level& data : levels_) {
+		data.center = glm::ivec3(1 << 30); // Requeued on the next update
+	}
+}
+
+const LoadRegion& LodManager::GetRegion(int level) const {
+	return level == 0 ? levels_[0].inner_region : region_;
+}
+
+glm::ivec3 LodManager::GetCenter(int level) const {
+	return level == 0 ? levels_[0].inner_center : levels_[level - 1].center;
+}
+
+bool LodManager::IsInRegion(int level, glm::ivec3 index) const {
+	return GetRegion(level).Contains(index - GetCenter(level));
+}
+
+const LodManager::TileMap& LodManager::GetTiles(int level) const {
+	return levels_[level - 1].tiles;
+}
+
+int LodManager::GetScale(int level) {
+	return 1 << level;
+}
+
+int LodManager::GetTileSize(int level) {
+	return Chunk::kSize * GetScale(level);
+}
+
+void LodManager::GenerateInput(int level, glm::ivec3 index, mesher::Input* input) {
+	PROFILE_SCOPE("LodManager::GenerateInput");
+
+	// Every cell takes the block at its center, so the surface stays at the same height on all levels as long as it is aligned
+	const int scale = GetScale(level);
+	const glm::ivec3 origin = index * Chunk::kSize * scale + scale / 2;
+	input->index = index;
+	input->scale = scale;
+	input->light.fill(light::Pack(light::kMaxLevel, 0)); // Distant terrain is only lit by the sky
+	for (int z = -1; z <= Chunk::kSize; ++z) {
+		for (int y = -1; y <= Chunk::kSize; ++y) {
+			for (int x = -1; x <= Chunk::kSize; ++x) {
+				input->blocks[mesher::Input::GetIndex(x, y, z)] = terrain::GetBlock(origin + glm::ivec3(x, y, z) * scale);
+			}
+		}
+	}
+
+	// Skirts: surface cells of the side borders are cleared, so the tile closes its edges with a one cell high wall
+	// Neighbouring tiles of another level or the full detail chunks may not line up exactly, which would leave cracks otherwise
+	for (int z = -1; z <= Chunk::kSize; ++z) {
+		for (int x = -1; x <= Chunk::kSize; ++x) {
+			if (x >= 0 && x < Chunk::kSize && z >= 0 && z < Chunk::kSize) {
+				continue;
+			}
+			for (int y = -1; y < Chunk::kSize; ++y) {
+				uint8_t& block = input->blocks[mesher::Input::GetIndex(x, y, z)];
+				if (block != 0 && input->blocks[mesher::Input::GetIndex(x, y + 1, z)] == 0) {
+					block = 0;
+				}
+			}
+		}
+	}
+}
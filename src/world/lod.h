@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include <src/utils/hash.h>
+#include <src/world/load_region.h>
+#include <src/world/mesher.h>
+
+// Coarse meshes of the terrain beyond the loaded chunks, sampled straight from terrain generation
+// Level n has cells of 2^n blocks, so a tile covers 2^n chunks per axis at the cost of a single chunk
+// Levels are nested regions around the player like a clipmap, each drawn only outside the region of the level below
+class LodManager {
+
+	using TileMap = std::unordered_map<glm::ivec3, std::shared_ptr<const ChunkMesh>, hash::Hash<glm::ivec3>>;
+
+public:
+	static inline constexpr int kNumLevels = 3;
+
+	// Maximum amount of work done per call to Update, the rest is deferred to later frames
+	struct Budget {
+		int max_meshes = 8;
+		float max_time_us = 1000.0f; // Zero or less disables the time limit
+	};
+
+	LodManager();
+	~LodManager();
+
+	// Chunks inside the inner region around the inner center are drawn at full detail
+	void Update(glm::vec3 pos, const LoadRegion& inner_region, glm::ivec3 inner_center);
+
+	void SetBudget(const Budget& budget);
+	const Budget& GetBudget() const;
+	int GetBacklog() const;
+
+	void SetRegion(const LoadRegion& region);
+
+	// Levels are numbered from 1, level 0 is the full detail region passed to Update
+	// Regions are in tiles of the level around its center, tiles outside of them are kept for hysteresis but shouldn't be drawn
+	const LoadRegion& GetRegion(int level) const;
+	glm::ivec3 GetCenter(int level) const;
+	bool IsInRegion(int level, glm::ivec3 index) const;
+	const TileMap& GetTiles(int level) const;
+
+	static int GetScale(int level);
+	static int GetTileSize(int level); // In blocks
+	// Downsamples terrain into a mesher input, with skirts along the sides to hide cracks between levels
+	static void GenerateInput(int level, glm::ivec3 index, mesher::Input* input);
+
+private:
+	struct Level {
+		glm::ivec3 center = glm::ivec3(1 << 30);
+		glm::ivec3 inner_center = glm::ivec3(0); // Region of the level below, tiles fully inside it are skipped
+		LoadRegion inner_region;
+		TileMap tiles;
+		std::vector<glm::ivec3> queue; // Sorted from farthest to nearest, so nearest tiles are popped first
+	};
+
+	void QueueTiles(int level);
+	bool IsHidden(int level, glm::ivec3 index) const;
+
+private:
+	std::array<Level, kNumLevels> levels_; // levels_[0] is level 1
+	LoadRegion region_; // In tiles of each level
+	std::vector<glm::ivec3> offsets_; // Offsets inside region_, sorted from nearest to farthest
+	int unload_offset_ = 1;
+	Budget budget_;
+};
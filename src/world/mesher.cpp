@@ -0,0 +1,391 @@
+#include "mesher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <src/world/block.h>
+#include <src/world/lighting.h>
+#include <src/utils/arena.h>
+#include <src/utils/profiler.h>
+
+namespace mesher {
+
+namespace {
+
+const glm::vec3 kCubeVertices[] = { // Block vertices
+	// Left
+	{ 0.0f, 0.0f, 0.0f },
+	{ 0.0f, 0.0f, 1.0f },
+	{ 0.0f, 1.0f, 1.0f },
+	{ 0.0f, 1.0f, 0.0f },
+	// Right
+	{ 1.0f, 0.0f, 1.0f },
+	{ 1.0f, 0.0f, 0.0f },
+	{ 1.0f, 1.0f, 0.0f },
+	{ 1.0f, 1.0f, 1.0f },
+	// Bottom
+	{ 1.0f, 0.0f, 1.0f },
+	{ 0.0f, 0.0f, 1.0f },
+	{ 0.0f, 0.0f, 0.0f },
+	{ 1.0f, 0.0f, 0.0f },
+	// Top
+	{ 0.0f, 1.0f, 1.0f },
+	{ 1.0f, 1.0f, 1.0f },
+	{ 1.0f, 1.0f, 0.0f },
+	{ 0.0f, 1.0f, 0.0f },
+	// Back
+	{ 1.0f, 0.0f, 0.0f },
+	{ 0.0f, 0.0f, 0.0f },
+	{ 0.0f, 1.0f, 0.0f },
+	{ 1.0f, 1.0f, 0.0f },
+	// Front
+	{ 0.0f, 0.0f, 1.0f },
+	{ 1.0f, 0.0f, 1.0f },
+	{ 1.0f, 1.0f, 1.0f },
+	{ 0.0f, 1.0f, 1.0f }
+};
+
+const glm::vec2 kQuadUVs[] = { // Block face texture coordinates
+	{ 0.f, 0.f }, // Bottom left
+	{ 1.f, 0.f }, // Bottom right
+	{ 1.f, 1.f }, // Top right
+	{ 0.f, 1.f }  // Top left
+};
+
+const uint32_t kQuadIndices[] = {
+	0, 1, 2, 0, 2, 3
+};
+
+const uint32_t kFlippedQuadIndices[] = { // Same winding, split along the other diagonal
+	1, 2, 3, 1, 3, 0
+};
+
+// Offset of the neighbouring block in the padded volume for each side
+template<typename Shape>
+constexpr int kSideOffsets[] = {
+	-1, +1,
+	-BasicInput<Shape>::kSizeX, +BasicInput<Shape>::kSizeX,
+	-BasicInput<Shape>::kSizeX * BasicInput<Shape>::kSizeY, +BasicInput<Shape>::kSizeX * BasicInput<Shape>::kSizeY
+};
+
+// Blocks that occlude a face corner, as offsets from the block in the padded volume
+// All three lie in the layer of air in front of the face: the two along the face edges and the diagonal one
+struct CornerOcclusion {
+	int side1;
+	int side2;
+	int corner;
+};
+
+template<typename Shape>
+std::array<std::array<CornerOcclusion, 4>, 6> MakeCornerOcclusion() {
+	auto to_offset = [](glm::ivec3 v) {
+		return v.x + BasicInput<Shape>::kSizeX * (v.y + BasicInput<Shape>::kSizeY * v.z);
+	};
+	std::array<std::array<CornerOcclusion, 4>, 6> table;
+	for (int side = 0; side < 6; ++side) {
+		const int dim = side / 2;
+		glm::ivec3 normal(0);
+		normal[dim] = (side % 2) * 2 - 1;
+		for (int corner = 0; corner < 4; ++corner) {
+			// Tangent directions point from the face center towards the corner
+			const glm::vec3& vertex = kCubeVertices[4 * side + corner];
+			glm::ivec3 tangent1(0), tangent2(0);
+			tangent1[(dim + 1) % 3] = vertex[(dim + 1) % 3] > 0.5f ? 1 : -1;
+			tangent2[(dim + 2) % 3] = vertex[(dim + 2) % 3] > 0.5f ? 1 : -1;
+			table[side][corner] = {
+				to_offset(normal + tangent1),
+				to_offset(normal + tangent2),
+				to_offset(normal + tangent1 + tangent2)
+			};
+		}
+	}
+	return table;
+}
+
+template<typename Shape>
+const auto kCornerOcclusion = MakeCornerOcclusion<Shape>();
+
+// 0 is fully occluded, 3 is unoccluded
+// - https://0fps.net/2013/07/03/ambient-occlusion-for-minecraft-like-worlds/
+int GetVertexAO(bool side1, bool side2, bool corner) {
+	if (side1 && side2) {
+		return 0; // The corner block can't make it any darker
+	}
+	return 3 - (side1 + side2 + corner);
+}
+
+// Smooth lighting, averaged over the non-opaque blocks of the layer in front of the corner
+// Like ambient occlusion, the corner block is hidden when both sides are opaque
+template<typename Shape>
+float GetVertexLight(const BasicInput<Shape>& input, int front, const CornerOcclusion& occlusion, int i) {
+	int sky = 0, block_light = 0, count = 0;
+	auto add = [&](int j) {
+		if (!block::IsOpaque(input.blocks[j])) {
+			sky += light::GetSky(input.light[j]);
+			block_light += light::GetBlock(input.light[j]);
+			++count;
+		}
+	};
+	add(front);
+	add(i + occlusion.side1);
+	add(i + occlusion.side2);
+	if (!block::IsOpaque(input.blocks[i + occlusion.side1]) || !block::IsOpaque(input.blocks[i + occlusion.side2])) {
+		add(i + occlusion.corner);
+	}
+	return (float)std::max(sky, block_light) / (float)(count * light::kMaxLevel);
+}
+
+// Every side of every block, two different non-opaque blocks both show their shared face (e.g. glass next to leaves)
+template<typename Shape>
+constexpr int kMaxQuads = 6 * Shape::kVolume;
+// Terrain surfaces stay well below this, so the scratch buffers rarely have to grow
+template<typename Shape>
+constexpr int kInitialQuads = Shape::kVolume / 4;
+constexpr int kFloatsPerQuad = 4 * 8;
+
+// Quads of the mesh being built, before they are grouped by render type
+struct ScratchQuads {
+	std::unique_ptr<Arena> arena;
+	int capacity = 0;
+	float* vertices = nullptr;
+	uint32_t* indices = nullptr;
+	uint8_t* render_types = nullptr;
+};
+
+// One per meshing thread and chunk shape, reused for every mesh once the result has been copied out
+template<typename Shape>
+ScratchQuads& GetScratchQuads() {
+	thread_local ScratchQuads scratch;
+	return scratch;
+}
+
+// Makes room for `capacity` quads, moving the first `num_quads` into a bigger arena if they don't fit.
+// The arena keeps its size for later meshes, the worst case (kMaxQuads) is about 900 bytes per block
+void ReserveQuads(ScratchQuads* scratch, int capacity, int num_quads) {
+	const size_t bytes = (size_t)capacity * (kFloatsPerQuad * sizeof(float) + 6 * sizeof(uint32_t) + sizeof(uint8_t)) + 64; // Alignment padding
+	std::unique_ptr<Arena> old_arena;
+	if (!scratch->arena || scratch->arena->GetCapacity() < bytes) {
+		old_arena = std::move(scratch->arena);
+		scratch->arena = std::make_unique<Arena>(bytes);
+	} else {
+		assert(num_quads == 0);
+		scratch->arena->Reset();
+	}
+
+	float* vertices = scratch->arena->Allocate<float>((size_t)capacity * kFloatsPerQuad);
+	uint32_t* indices = scratch->arena->Allocate<uint32_t>((size_t)capacity * 6);
+	uint8_t* render_types = scratch->arena->Allocate<uint8_t>(capacity);
+	assert(vertices && indices && render_types);
+	if (num_quads > 0) {
+		std::memcpy(vertices, scratch->vertices, (size_t)num_quads * kFloatsPerQuad * sizeof(float));
+		std::memcpy(indices, scratch->indices, (size_t)num_quads * 6 * sizeof(uint32_t));
+		std::memcpy(render_types, scratch->render_types, num_quads);
+	}
+	scratch->capacity = capacity;
+	scratch->vertices = vertices;
+	scratch->indices = indices;
+	scratch->render_types = render_types;
+}
+
+std::atomic<uint64_t> next_mesh_id = 1;
+
+} // namespace
+
+template<typename Shape>
+void Gather(const BasicNeighborhood<Shape>& chunks, BasicInput<Shape>* input) {
+	using Input = BasicInput<Shape>;
+	const glm::ivec3 size(Shape::kSizeX, Shape::kSizeY, Shape::kSizeZ);
+	input->index = chunks[13]->index_;
+	input->scale = 1;
+	input->blocks.fill(0);
+	input->light.fill(light::Pack(light::kMaxLevel, 0));
+
+	// Each chunk of the neighbourhood covers the whole chunk, a layer, a row or a single block of the border
+	// Per dimension: the range in the padded volume, and where it starts inside that chunk
+	auto range = [](int offset, int n, int* begin, int* end, int* src) {
+		*begin = offset < 0 ? -1 : offset == 0 ? 0 : n;
+		*end = offset < 0 ? 0 : offset == 0 ? n : n + 1;
+		*src = offset < 0 ? n - 1 : 0;
+	};
+
+	for (int i = 0; i < 27; ++i) {
+		const BasicChunk<Shape>* chunk = chunks[i];
+		if (!chunk) {
+			continue;
+		}
+		glm::ivec3 begin, end, src;
+		range(i % 3 - 1, size.x, &begin.x, &end.x, &src.x);
+		range(i / 3 % 3 - 1, size.y, &begin.y, &end.y, &src.y);
+		range(i / 9 - 1, size.z, &begin.z, &end.z, &src.z);
+
+		const int length = end.x - begin.x;
+		for (int z = begin.z; z < end.z; ++z) {
+			for (int y = begin.y; y < end.y; ++y) {
+				int src_index = Shape::GetIndex(src.x, src.y + y - begin.y, src.z + z - begin.z);
+				const int dst_index = Input::GetIndex(begin.x, y, z);
+				if constexpr (Shape::kLayout == ChunkLayout::kLinear) {
+					std::copy_n(&chunk->data_[src_index], length, &input->blocks[dst_index]);
+					std::copy_n(&chunk->light_[src_index], length, &input->light[dst_index]);
+				} else {
+					// Rows aren't contiguous, they are walked one step along x at a time
+					for (int x = 0; x < length; ++x) {
+						input->blocks[dst_index + x] = chunk->data_[src_index];
+						input->light[dst_index + x] = chunk->light_[src_index];
+						if (x + 1 < length) {
+							src_index = Shape::Step(src_index, 0, +1);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+template<typename Shape>
+std::shared_ptr<const ChunkMesh> GenerateMesh(const BasicInput<Shape>& input) {
+	PROFILE_SCOPE("mesher::GenerateMesh");
+	using Input = BasicInput<Shape>;
+
+	ScratchQuads& scratch = GetScratchQuads<Shape>();
+	ReserveQuads(&scratch, std::max(scratch.capacity, kInitialQuads<Shape>), 0);
+	int num_quads = 0;
+	std::array<int, block::kNumRenderTypes> type_quads = {};
+	const float scale = (float)input.scale;
+	const glm::vec3 chunk_pos(glm::ivec3(Shape::kSizeX, Shape::kSizeY, Shape::kSizeZ) * input.scale * input.index);
+	for (int z = 0; z < Shape::kSizeZ; ++z) {
+		for (int y = 0; y < Shape::kSizeY; ++y) {
+			for (int x = 0; x < Shape::kSizeX; ++x) {
+				const int i = Input::GetIndex(x, y, z);
+				const uint8_t id = input.blocks[i];
+				if (id == block::kAir) {
+					continue;
+				}
+				const block::Info& info = block::GetInfo(id);
+
+				// The border makes every neighbour lookup a plain array access
+				const glm::vec3 block_offset(x, y, z);
+				for (int side = 0; side < 6; ++side) {
+					if (block::IsFaceHidden(id, input.blocks[i + kSideOffsets<Shape>[side]])) {
+						continue;
+					}
+					// Ambient occlusion reads the same padded volume, so it costs no lookups outside of it
+					int ao[4];
+					float light[4];
+					for (int corner = 0; corner < 4; ++corner) {
+						const CornerOcclusion& occlusion = kCornerOcclusion<Shape>[side][corner];
+						ao[corner] = GetVertexAO(
+							block::IsOpaque(input.blocks[i + occlusion.side1]),
+							block::IsOpaque(input.blocks[i + occlusion.side2]),
+							block::IsOpaque(input.blocks[i + occlusion.corner])
+						);
+						light[corner] = GetVertexLight(input, i + kSideOffsets<Shape>[side], occlusion, i);
+					}
+
+					if (num_quads == scratch.capacity) {
+						assert(num_quads < kMaxQuads<Shape>);
+						ReserveQuads(&scratch, std::min(2 * scratch.capacity, kMaxQuads<Shape>), num_quads);
+					}
+					float* vertex = scratch.vertices + kFloatsPerQuad * num_quads;
+					for (int corner = 0; corner < 4; ++corner) {
+						glm::vec3 pos = scale * (kCubeVertices[4 * side + corner] + block_offset) + chunk_pos;
+						glm::vec2 uv = scale * kQuadUVs[corner]; // The tile repeats, so coarse cells still show one per block
+						*vertex++ = pos.x;
+						*vertex++ = pos.y;
+						*vertex++ = pos.z;
+						*vertex++ = uv.x;
+						*vertex++ = uv.y;
+						*vertex++ = (float)ao[corner] / 3.0f;
+						*vertex++ = light[corner];
+						*vertex++ = (float)info.tiles[side];
+					}
+
+					// Split along the brighter diagonal, otherwise a single dark corner bleeds across the whole quad
+					const uint32_t* quad_indices = ao[1] + ao[3] > ao[0] + ao[2] ? kFlippedQuadIndices : kQuadIndices;
+					uint32_t* index = scratch.indices + 6 * num_quads;
+					for (int j = 0; j < 6; ++j) {
+						index[j] = quad_indices[j] + 4 * num_quads;
+					}
+					scratch.render_types[num_quads] = (uint8_t)info.render_type;
+					++type_quads[info.render_type];
+					++num_quads;
+				}
+			}
+		}
+	}
+
+	const float* vertices = scratch.vertices;
+	const uint32_t* indices = scratch.indices;
+	const uint8_t* render_types = scratch.render_types;
+
+	// Meshes are immutable once created, so they can be shared with the render thread
+	auto mesh = std::make_shared<ChunkMesh>();
+	mesh->id = next_mesh_id.fetch_add(1, std::memory_order_relaxed);
+	mesh->index_offsets[0] = 0;
+	for (int type = 0; type < block::kNumRenderTypes; ++type) {
+		mesh->index_offsets[type + 1] = mesh->index_offsets[type] + 6 * type_quads[type];
+	}
+	if (type_quads[block::kOpaque] == num_quads) {
+		mesh->vertices.assign(vertices, vertices + kFloatsPerQuad * num_quads);
+		mesh->indices.assign(indices, indices + 6 * num_quads);
+		return mesh;
+	}
+
+	// Quads are grouped by render type in one pass, keeping their order within a group and moving their indices along
+	mesh->vertices.resize(kFloatsPerQuad * num_quads);
+	mesh->indices.resize(6 * num_quads);
+	std::array<uint32_t, block::kNumRenderTypes> next_quad;
+	for (int type = 0; type < block::kNumRenderTypes; ++type) {
+		next_quad[type] = mesh->index_offsets[type] / 6;
+	}
+	for (int quad = 0; quad < num_quads; ++quad) {
+		const uint32_t dst = next_quad[render_types[quad]]++;
+		std::memcpy(&mesh->vertices[kFloatsPerQuad * dst], vertices + kFloatsPerQuad * quad, kFloatsPerQuad * sizeof(float));
+		for (int j = 0; j < 6; ++j) {
+			mesh->indices[6 * dst + j] = indices[6 * quad + j] - 4 * quad + 4 * dst;
+		}
+	}
+	return mesh;
+}
+
+void SortTranslucent(const ChunkMesh& mesh, glm::vec3 eye, std::vector<uint32_t>* indices) {
+	PROFILE_SCOPE("mesher::SortTranslucent");
+	const uint32_t first_quad = mesh.index_offsets[block::kTranslucent] / 6;
+	const uint32_t num_quads = (uint32_t)mesh.GetNumIndices(block::kTranslucent) / 6;
+
+	// Squared distance to the quad center, every quad is sorted as a whole
+	thread_local std::vector<std::pair<float, uint32_t>> keys;
+	keys.resize(num_quads);
+	for (uint32_t i = 0; i < num_quads; ++i) {
+		const float* vertex = &mesh.vertices[kFloatsPerQuad * (first_quad + i)];
+		glm::vec3 center(0.0f);
+		for (int corner = 0; corner < 4; ++corner) {
+			center += glm::vec3(vertex[0], vertex[1], vertex[2]);
+			vertex += kFloatsPerQuad / 4;
+		}
+		const glm::vec3 offset = 0.25f * center - eye;
+		keys[i] = { glm::dot(offset, offset), first_quad + i };
+	}
+	std::sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) {
+		return a.first > b.first;
+	});
+
+	indices->resize(6 * num_quads);
+	for (uint32_t i = 0; i < num_quads; ++i) {
+		std::copy_n(&mesh.indices[6 * keys[i].second], 6, &(*indices)[6 * i]);
+	}
+}
+
+template void Gather(const BasicNeighborhood<LinearChunkShape>&, BasicInput<LinearChunkShape>*);
+template void Gather(const BasicNeighborhood<MortonChunkShape>&, BasicInput<MortonChunkShape>*);
+template void Gather(const BasicNeighborhood<LargeChunkShape>&, BasicInput<LargeChunkShape>*);
+template void Gather(const BasicNeighborhood<ColumnChunkShape>&, BasicInput<ColumnChunkShape>*);
+
+template std::shared_ptr<const ChunkMesh> GenerateMesh(const BasicInput<LinearChunkShape>&);
+template std::shared_ptr<const ChunkMesh> GenerateMesh(const BasicInput<MortonChunkShape>&);
+template std::shared_ptr<const ChunkMesh> GenerateMesh(const BasicInput<LargeChunkShape>&);
+template std::shared_ptr<const ChunkMesh> GenerateMesh(const BasicInput<ColumnChunkShape>&);
+
+} // namespace mesher
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <src/world/chunk.h>
+
+// Chunk meshing without GL or chunk manager state, so it can run on any thread
+namespace mesher {
+
+// Blocks and light of a chunk surrounded by a one block border copied from its neighbours
+// A value type, so it can be handed to another thread while the chunk keeps changing
+template<typename Shape>
+struct BasicInput {
+	static inline constexpr int kSizeX = Shape::kSizeX + 2;
+	static inline constexpr int kSizeY = Shape::kSizeY + 2;
+	static inline constexpr int kSizeZ = Shape::kSizeZ + 2;
+	static inline constexpr int kVolume = kSizeX * kSizeY * kSizeZ;
+
+	glm::ivec3 index; // In units of the chunk size times scale blocks
+	int scale = 1; // Blocks per cell, above 1 for level of detail meshes
+	std::array<uint8_t, kVolume> blocks;
+	std::array<uint8_t, kVolume> light; // Packed like Chunk::light_
+
+	// Chunk local coordinates in [-1, size]
+	static constexpr int GetIndex(int x, int y, int z) {
+		return (x + 1) + kSizeX * ((y + 1) + kSizeY * (z + 1));
+	}
+};
+
+using Input = BasicInput<Chunk::Shape>;
+
+// 3x3x3 chunks around the meshed one, indexed by GetNeighborIndex, missing ones are treated as air open to the sky
+// Diagonal neighbours are needed for ambient occlusion at edges and corners
+template<typename Shape>
+using BasicNeighborhood = std::array<const BasicChunk<Shape>*, 27>;
+
+using Neighborhood = BasicNeighborhood<Chunk::Shape>;
+
+inline int GetNeighborIndex(glm::ivec3 offset) {
+	return (offset.x + 1) + 3 * ((offset.y + 1) + 3 * (offset.z + 1));
+}
+
+// Both are compiled for LinearChunkShape, MortonChunkShape, LargeChunkShape and ColumnChunkShape
+template<typename Shape>
+void Gather(const BasicNeighborhood<Shape>& chunks, BasicInput<Shape>* input);
+
+// Vertices are emitted into a per-thread arena sized for the worst case chunk,
+// so the only allocations are the returned mesh and its two buffers
+template<typename Shape>
+std::shared_ptr<const ChunkMesh> GenerateMesh(const BasicInput<Shape>& input);
+
+// Indices of the mesh's translucent quads, farthest from the eye first, to replace that range of the mesh's indices
+// Blending depends on draw order, and translucent faces of one chunk can overlap each other
+void SortTranslucent(const ChunkMesh& mesh, glm::vec3 eye, std::vector<uint32_t>* indices);
+
+} // namespace mesher
@@ -0,0 +1,84 @@
+#include "raycast.h"
+
+#include <cmath>
+#include <limits>
+#include <src/world/block.h>
+#include <src/world/chunk_manager.h>
+#include <src/world/chunk.h>
+
+// Amanatides, Woo. "A Fast Voxel Traversal Algorithm for Ray Tracing."
+// http://www.cse.yorku.ca/~amana/research/grid.pdf
+
+namespace raycast {
+
+bool CastRay(const ChunkManager& chunk_manager, glm::vec3 origin, glm::vec3 direction, float max_distance, Hit* hit) {
+	const float kInf = std::numeric_limits<float>::infinity();
+	const glm::vec3 dir = glm::normalize(direction);
+
+	glm::ivec3 block(glm::floor(origin));
+	glm::ivec3 step;
+	glm::vec3 t_max; // Distance along the ray to the next voxel boundary on each axis
+	glm::vec3 t_delta; // Distance along the ray between two voxel boundaries on each axis
+	for (int i = 0; i < 3; ++i) {
+		if (dir[i] > 0.0f) {
+			step[i] = 1;
+			t_delta[i] = 1.0f / dir[i];
+			t_max[i] = ((float)block[i] + 1.0f - origin[i]) * t_delta[i];
+		} else if (dir[i] < 0.0f) {
+			step[i] = -1;
+			t_delta[i] = -1.0f / dir[i];
+			t_max[i] = (origin[i] - (float)block[i]) * t_delta[i];
+		} else {
+			step[i] = 0;
+			t_delta[i] = kInf;
+			t_max[i] = kInf;
+		}
+	}
+
+	// Only look up the chunk map when the ray crosses into a different chunk
+	glm::ivec3 chunk_index = ChunkManager::GetChunkIndex(block);
+	glm::ivec3 local = block - chunk_index * Chunk::kSize;
+	const Chunk* chunk = chunk_manager.GetChunk(chunk_index);
+
+	glm::ivec3 normal(0);
+	float t = 0.0f;
+	while (t <= max_distance) {
+		if (chunk) {
+			uint8_t id = chunk->GetBlock(local);
+			if (block::IsSolid(id)) {
+				if (hit) {
+					hit->block = block;
+					hit->normal = normal;
+					hit->distance = t;
+					hit->id = id;
+				}
+				return true;
+			}
+		}
+
+		int axis = 0;
+		if (t_max[1] < t_max[axis]) {
+			axis = 1;
+		}
+		if (t_max[2] < t_max[axis]) {
+			axis = 2;
+		}
+
+		t = t_max[axis];
+		t_max[axis] += t_delta[axis];
+		block[axis] += step[axis];
+		local[axis] += step[axis];
+		normal = glm::ivec3(0);
+		normal[axis] = -step[axis];
+
+		if (local[axis] < 0 || local[axis] >= Chunk::kSize) {
+			chunk_index[axis] += step[axis];
+			local[axis] -= step[axis] * Chunk::kSize;
+			chunk = chunk_manager.GetChunk(chunk_index);
+		}
+	}
+
+	return false;
+}
+
+} // namespace raycast
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class ChunkManager;
+
+namespace raycast {
+
+struct Hit {
+	glm::ivec3 block;
+	glm::ivec3 normal; // Normal of the face the ray entered through, zero if the ray started inside the block
+	float distance;
+	uint8_t id;
+};
+
+// Traverse voxels along the ray until a solid block is hit, unloaded chunks are treated as air
+bool CastRay(const ChunkManager& chunk_manager, glm::vec3 origin, glm::vec3 direction, float max_distance, Hit* hit);
+
+} // namespace raycast
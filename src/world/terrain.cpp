@@ -0,0 +1,17 @@
+#include "terrain.h"
+
+#include <src/world/chunk.h>
+
+namespace terrain {
+
+void GenerateChunk(Chunk* chunk) {
+	// Flat world, solid below y = 0
+	uint8_t block = chunk->index_.y >= 0 ? 0 : 1;
+	chunk->data_.fill(block);
+}
+
+uint8_t GetBlock(glm::ivec3 pos) {
+	return pos.y >= 0 ? 0 : 1;
+}
+
+} // namespace terrain
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class Chunk;
+
+namespace terrain {
+
+// Fills a newly created chunk, the same chunk index always produces the same blocks
+void GenerateChunk(Chunk* chunk);
+
+// Single generated block in world coordinates, used where whole chunks aren't needed
+uint8_t GetBlock(glm::ivec3 pos);
+
+} // namespace terrain